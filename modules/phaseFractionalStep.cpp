@@ -5,7 +5,7 @@
 #include "CommandLine.h"
 #include "ConstructGrid.h"
 #include "FractionalStep.h"
-#include "CgnsViewer.h"
+#include "ConstructViewer.h"
 #include "RunControl.h"
 
 int main(int argc, char *argv[])
@@ -22,10 +22,10 @@ int main(int argc, char *argv[])
     shared_ptr<FiniteVolumeGrid2D> grid = constructGrid(input, std::make_shared<Communicator>());
 
     FractionalStep solver(input, grid);
-    CgnsViewer viewer(input, solver);
+    auto viewer = constructViewer(input, solver);
 
     RunControl runControl;
-    runControl.run(input, solver, viewer);
+    runControl.run(input, solver, *viewer);
 
     Communicator::finalize();
 
@@ -3,7 +3,7 @@
 #include "Input.h"
 #include "CommandLine.h"
 #include "ConstructGrid.h"
-#include "CgnsViewer.h"
+#include "ConstructViewer.h"
 #include "Poisson.h"
 #include "Time.h"
 
@@ -21,7 +21,7 @@ int main(int argc, char *argv[])
     shared_ptr<FiniteVolumeGrid2D> grid = constructGrid(input, std::make_shared<Communicator>());
 
     Poisson solver(input, grid);
-    CgnsViewer viewer(input, solver);
+    auto viewer = constructViewer(input, solver);
 
     Time time;
 
@@ -31,7 +31,8 @@ int main(int argc, char *argv[])
 
     solver.printf("Time elapsed = %s\n", time.elapsedTime().c_str());
 
-    viewer.write(1);
+    viewer->write(1);
+    viewer->flush();
 
     Communicator::finalize();
 
@@ -6,12 +6,52 @@
 #include "Communicator.h"
 #include "Exception.h"
 
+namespace
+{
+    template<class T>
+    std::vector<std::vector<T>> allToAllv(MPI_Comm comm, const std::vector<std::vector<T>> &sendBuffers,
+                                          MPI_Datatype type)
+    {
+        int nProcs;
+        MPI_Comm_size(comm, &nProcs);
+
+        std::vector<int> sendSizes(nProcs), recvSizes(nProcs);
+        std::vector<T> sendBuffer;
+
+        for (int proc = 0; proc < nProcs; ++proc)
+        {
+            sendSizes[proc] = sendBuffers[proc].size();
+            sendBuffer.insert(sendBuffer.end(), sendBuffers[proc].begin(), sendBuffers[proc].end());
+        }
+
+        MPI_Alltoall(sendSizes.data(), 1, MPI_INT, recvSizes.data(), 1, MPI_INT, comm);
+
+        std::vector<int> sendDispls(1, 0), recvDispls(1, 0);
+        std::partial_sum(sendSizes.begin(), sendSizes.end() - 1, std::back_inserter(sendDispls));
+        std::partial_sum(recvSizes.begin(), recvSizes.end() - 1, std::back_inserter(recvDispls));
+
+        std::vector<T> recvBuffer(recvDispls.back() + recvSizes.back());
+
+        MPI_Alltoallv(sendBuffer.data(), sendSizes.data(), sendDispls.data(), type,
+                      recvBuffer.data(), recvSizes.data(), recvDispls.data(), type, comm);
+
+        std::vector<std::vector<T>> recvBuffers(nProcs);
+
+        for (int proc = 0; proc < nProcs; ++proc)
+            recvBuffers[proc].assign(recvBuffer.begin() + recvDispls[proc],
+                                     recvBuffer.begin() + recvDispls[proc] + recvSizes[proc]);
+
+        return recvBuffers;
+    }
+}
+
 MPI_Datatype Communicator::MPI_VECTOR2D_;
 MPI_Datatype Communicator::MPI_TENSOR2D_;
+int Communicator::threadSupport_ = MPI_THREAD_SINGLE;
 
-void Communicator::init(int argc, char *argv[])
+void Communicator::init(int argc, char *argv[], int threadLevel)
 {
-    MPI_Init(&argc, &argv);
+    MPI_Init_thread(&argc, &argv, threadLevel, &threadSupport_);
     MPI_Type_vector(1, 2, 2, MPI_DOUBLE, &MPI_VECTOR2D_);
     MPI_Type_vector(1, 4, 4, MPI_DOUBLE, &MPI_TENSOR2D_);
     MPI_Type_commit(&MPI_VECTOR2D_);
@@ -32,7 +72,11 @@ Communicator::Communicator(MPI_Comm comm)
 
 Communicator::~Communicator()
 {
+    int finalized;
+    MPI_Finalized(&finalized);
 
+    if (ownsComm_ && !finalized)
+        MPI_Comm_free(&comm_);
 }
 
 int Communicator::printf(const char *format, ...) const
@@ -127,6 +171,13 @@ void Communicator::broadcast(int root, std::vector<Vector2D> &vector2Ds) const
     MPI_Bcast(vector2Ds.data(), vector2Ds.size(), MPI_VECTOR2D_, root, comm_);
 }
 
+void Communicator::broadcast(int root, std::string &str) const
+{
+    int size = broadcast(root, (int) str.size());
+    str.resize(size);
+    MPI_Bcast(&str[0], size, MPI_CHAR, root, comm_);
+}
+
 int Communicator::scatter(int root, const std::vector<int> &send) const
 {
     int num[1];
@@ -155,6 +206,17 @@ std::vector<Vector2D> Communicator::allGather(const Vector2D &val) const
     return result;
 }
 
+std::vector<int> Communicator::allGatherv(const std::vector<int>& vals) const
+{
+    std::vector<int> sizes = allGather((int)vals.size());
+    std::vector<int> result(std::accumulate(sizes.begin(), sizes.end(), 0));
+    std::vector<int> displs(1, 0);
+    std::partial_sum(sizes.begin(), sizes.end() - 1, std::back_inserter(displs));
+    MPI_Allgatherv(vals.data(), vals.size(), MPI_INT, result.data(), sizes.data(), displs.data(), MPI_INT, comm_);
+
+    return result;
+}
+
 std::vector<Scalar> Communicator::allGatherv(const std::vector<double>& vals) const
 {
     std::vector<int> sizes = allGather((int)vals.size());
@@ -177,6 +239,31 @@ std::vector<Vector2D> Communicator::allGatherv(const std::vector<Vector2D>& vals
     return result;
 }
 
+std::vector<std::vector<unsigned long>> Communicator::allToAllv(const std::vector<std::vector<unsigned long>> &sendBuffers) const
+{
+    return ::allToAllv(comm_, sendBuffers, MPI_UNSIGNED_LONG);
+}
+
+std::vector<std::vector<int>> Communicator::allToAllv(const std::vector<std::vector<int>> &sendBuffers) const
+{
+    return ::allToAllv(comm_, sendBuffers, MPI_INT);
+}
+
+std::vector<std::vector<double>> Communicator::allToAllv(const std::vector<std::vector<double>> &sendBuffers) const
+{
+    return ::allToAllv(comm_, sendBuffers, MPI_DOUBLE);
+}
+
+std::vector<std::vector<Vector2D>> Communicator::allToAllv(const std::vector<std::vector<Vector2D>> &sendBuffers) const
+{
+    return ::allToAllv(comm_, sendBuffers, MPI_VECTOR2D_);
+}
+
+std::vector<std::vector<Tensor2D>> Communicator::allToAllv(const std::vector<std::vector<Tensor2D>> &sendBuffers) const
+{
+    return ::allToAllv(comm_, sendBuffers, MPI_TENSOR2D_);
+}
+
 std::vector<int> Communicator::gather(int root, int val) const
 {
     std::vector<int> result(nProcs());
@@ -255,67 +342,213 @@ void Communicator::recv(int source, std::vector<Vector2D> &vals, int tag) const
     MPI_Recv(vals.data(), vals.size(), MPI_VECTOR2D_, source, tag, comm_, &status);
 }
 
-void Communicator::isend(int dest, const std::vector<unsigned long> &vals, int tag) const
+void Communicator::isend(int dest, const std::vector<int> &vals, Requests &requests, int tag) const
+{
+    MPI_Request request;
+    MPI_Isend(vals.data(), vals.size(), MPI_INT, dest, tag, comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::isend(int dest, const std::vector<unsigned long> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Isend(vals.data(), vals.size(), MPI_UNSIGNED_LONG, dest, tag, comm_, &request);
-    currentRequests_.push_back(request);
+
+    requests.push_back(request);
+}
+
+void Communicator::isend(int dest, const std::vector<double> &vals, Requests &requests, int tag) const
+{
+    MPI_Request request;
+    MPI_Isend(vals.data(), vals.size(), MPI_DOUBLE, dest, tag, comm_, &request);
+
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, std::vector<int> &vals, int tag) const
+void Communicator::isend(int dest, const std::vector<Vector2D> &vals, Requests &requests, int tag) const
+{
+    MPI_Request request;
+    MPI_Isend(vals.data(), vals.size(), MPI_VECTOR2D_, dest, tag, comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::isend(int dest, const std::vector<Tensor2D> &vals, Requests &requests, int tag) const
+{
+    MPI_Request request;
+    MPI_Isend(vals.data(), vals.size(), MPI_TENSOR2D_, dest, tag, comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::irecv(int source, std::vector<int> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(vals.data(), vals.size(), MPI_INT, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, std::vector<unsigned long> &vals, int tag) const
+void Communicator::irecv(int source, std::vector<unsigned long> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(vals.data(), vals.size(), MPI_UNSIGNED_LONG, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, std::vector<double> &vals, int tag) const
+void Communicator::irecv(int source, std::vector<double> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(vals.data(), vals.size(), MPI_DOUBLE, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, std::vector<Vector2D> &vals, int tag) const
+void Communicator::irecv(int source, std::vector<Vector2D> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(vals.data(), vals.size(), MPI_VECTOR2D_, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, std::vector<Tensor2D>& vals, int tag) const
+void Communicator::irecv(int source, std::vector<Tensor2D> &vals, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(vals.data(), vals.size(), MPI_TENSOR2D_, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
 }
 
-void Communicator::irecv(int source, unsigned long &val, int tag) const
+void Communicator::irecv(int source, unsigned long &val, Requests &requests, int tag) const
 {
     MPI_Request request;
     MPI_Irecv(&val, 1, MPI_UNSIGNED_LONG, source, tag, comm_, &request);
 
-    currentRequests_.push_back(request);
+    requests.push_back(request);
+}
+
+void Communicator::waitAll(Requests &requests) const
+{
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    requests.clear();
+}
+
+bool Communicator::testAll(Requests &requests) const
+{
+    int flag;
+    MPI_Testall(requests.size(), requests.data(), &flag, MPI_STATUSES_IGNORE);
+
+    if (flag)
+        requests.clear();
+
+    return flag;
+}
+
+std::shared_ptr<Communicator> Communicator::createDistGraph(const std::vector<int> &sources,
+                                                            const std::vector<int> &destinations,
+                                                            bool reorder) const
+{
+    MPI_Comm graphComm;
+    MPI_Dist_graph_create_adjacent(comm_,
+                                   sources.size(), sources.data(), MPI_UNWEIGHTED,
+                                   destinations.size(), destinations.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, reorder, &graphComm);
+
+    auto comm = std::make_shared<Communicator>(graphComm);
+    comm->ownsComm_ = true;
+
+    return comm;
 }
 
-void Communicator::waitAll() const
+std::shared_ptr<Communicator> Communicator::splitShared() const
 {
-    std::vector<MPI_Status> statuses(currentRequests_.size());
-    MPI_Waitall(currentRequests_.size(), currentRequests_.data(), statuses.data());
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, rank(), MPI_INFO_NULL, &nodeComm);
 
-    currentRequests_.clear();
+    auto comm = std::make_shared<Communicator>(nodeComm);
+    comm->ownsComm_ = true;
+
+    return comm;
+}
+
+std::shared_ptr<Communicator> Communicator::duplicate() const
+{
+    MPI_Comm dupComm;
+    MPI_Comm_dup(comm_, &dupComm);
+
+    auto comm = std::make_shared<Communicator>(dupComm);
+    comm->ownsComm_ = true;
+
+    return comm;
+}
+
+void Communicator::ineighbourAllToAllv(const std::vector<int> &sendBuffer, const std::vector<int> &sendCounts,
+                                       const std::vector<int> &sendDispls, std::vector<int> &recvBuffer,
+                                       const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                                       Requests &requests) const
+{
+    MPI_Request request;
+    MPI_Ineighbor_alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_INT,
+                            recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_INT,
+                            comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::ineighbourAllToAllv(const std::vector<unsigned long> &sendBuffer, const std::vector<int> &sendCounts,
+                                       const std::vector<int> &sendDispls, std::vector<unsigned long> &recvBuffer,
+                                       const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                                       Requests &requests) const
+{
+    MPI_Request request;
+    MPI_Ineighbor_alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_UNSIGNED_LONG,
+                            recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_UNSIGNED_LONG,
+                            comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::ineighbourAllToAllv(const std::vector<double> &sendBuffer, const std::vector<int> &sendCounts,
+                                       const std::vector<int> &sendDispls, std::vector<double> &recvBuffer,
+                                       const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                                       Requests &requests) const
+{
+    MPI_Request request;
+    MPI_Ineighbor_alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_DOUBLE,
+                            recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_DOUBLE,
+                            comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::ineighbourAllToAllv(const std::vector<Vector2D> &sendBuffer, const std::vector<int> &sendCounts,
+                                       const std::vector<int> &sendDispls, std::vector<Vector2D> &recvBuffer,
+                                       const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                                       Requests &requests) const
+{
+    MPI_Request request;
+    MPI_Ineighbor_alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_VECTOR2D_,
+                            recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_VECTOR2D_,
+                            comm_, &request);
+
+    requests.push_back(request);
+}
+
+void Communicator::ineighbourAllToAllv(const std::vector<Tensor2D> &sendBuffer, const std::vector<int> &sendCounts,
+                                       const std::vector<int> &sendDispls, std::vector<Tensor2D> &recvBuffer,
+                                       const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                                       Requests &requests) const
+{
+    MPI_Request request;
+    MPI_Ineighbor_alltoallv(sendBuffer.data(), sendCounts.data(), sendDispls.data(), MPI_TENSOR2D_,
+                            recvBuffer.data(), recvCounts.data(), recvDispls.data(), MPI_TENSOR2D_,
+                            comm_, &request);
+
+    requests.push_back(request);
 }
 
 template<>
@@ -377,6 +610,20 @@ Vector2D Communicator::sum(const Vector2D& val) const
     return std::accumulate(vals.begin(), vals.end(), Vector2D(0., 0.));
 }
 
+std::vector<double> Communicator::sum(const std::vector<double>& vals) const
+{
+    std::vector<double> result(vals.size());
+    MPI_Allreduce(vals.data(), result.data(), vals.size(), MPI_DOUBLE, MPI_SUM, comm_);
+    return result;
+}
+
+std::vector<Vector2D> Communicator::sum(const std::vector<Vector2D>& vals) const
+{
+    std::vector<Vector2D> result(vals.size());
+    MPI_Allreduce(vals.data(), result.data(), 2 * vals.size(), MPI_DOUBLE, MPI_SUM, comm_);
+    return result;
+}
+
 int Communicator::min(int val) const
 {
     int result;
@@ -391,6 +638,13 @@ double Communicator::min(double val) const
     return result;
 }
 
+int Communicator::max(int val) const
+{
+    int result;
+    MPI_Allreduce(&val, &result, 1, MPI_INT, MPI_MAX, comm_);
+    return result;
+}
+
 double Communicator::max(double val) const
 {
     double result;
@@ -3,6 +3,8 @@
 
 #include <mpi.h>
 #include <vector>
+#include <memory>
+#include <string>
 
 #include "Vector2D.h"
 #include "Tensor2D.h"
@@ -11,14 +13,25 @@ class Communicator
 {
 public:
 
-    static void init(int argc, char *argv[]);
+    //- Per-exchange request set. Each exchange owns its requests, so concurrent exchanges do not interfere
+    typedef std::vector<MPI_Request> Requests;
+
+    static void init(int argc, char *argv[], int threadLevel = MPI_THREAD_FUNNELED);
 
     static void finalize();
 
+    //- Thread support level provided by the MPI implementation
+    static int threadSupport()
+    { return threadSupport_; }
+
     Communicator(MPI_Comm comm = MPI_COMM_WORLD);
 
+    Communicator(const Communicator &other) = delete;
+
     ~Communicator();
 
+    Communicator &operator=(const Communicator &other) = delete;
+
     //- Printing
 
     int printf(const char *format, ...) const;
@@ -57,6 +70,8 @@ public:
 
     void broadcast(int root, std::vector<Vector2D> &vector2Ds) const;
 
+    void broadcast(int root, std::string &str) const;
+
     //- Collectives
 
     //- Scatter
@@ -70,10 +85,23 @@ public:
     std::vector<Vector2D> allGather(const Vector2D& val) const;
 
     //- Allgatherv
+    std::vector<int> allGatherv(const std::vector<int>& vals) const;
+
     std::vector<Scalar> allGatherv(const std::vector<double>& vals) const;
 
     std::vector<Vector2D> allGatherv(const std::vector<Vector2D>& vals) const;
 
+    //- Alltoallv, sendBuffers[proc] is sent to proc and the result holds the buffer received from each proc
+    std::vector<std::vector<unsigned long>> allToAllv(const std::vector<std::vector<unsigned long>> &sendBuffers) const;
+
+    std::vector<std::vector<int>> allToAllv(const std::vector<std::vector<int>> &sendBuffers) const;
+
+    std::vector<std::vector<double>> allToAllv(const std::vector<std::vector<double>> &sendBuffers) const;
+
+    std::vector<std::vector<Vector2D>> allToAllv(const std::vector<std::vector<Vector2D>> &sendBuffers) const;
+
+    std::vector<std::vector<Tensor2D>> allToAllv(const std::vector<std::vector<Tensor2D>> &sendBuffers) const;
+
     //- gather
     std::vector<int> gather(int root, int val) const;
 
@@ -103,21 +131,75 @@ public:
 
     //- Non-blocking point-to-point communication
 
-    void isend(int dest, const std::vector<unsigned long>& vals, int tag = MPI_ANY_TAG) const;
+    void isend(int dest, const std::vector<int>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
+
+    void isend(int dest, const std::vector<unsigned long>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
+
+    void isend(int dest, const std::vector<double>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
+
+    void isend(int dest, const std::vector<Vector2D>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
+
+    void isend(int dest, const std::vector<Tensor2D>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, std::vector<int> &vals, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, std::vector<int> &vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, std::vector<unsigned long> &vals, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, std::vector<unsigned long> &vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, std::vector<double> &vals, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, std::vector<double> &vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, std::vector<Vector2D> &vals, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, std::vector<Vector2D> &vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, std::vector<Tensor2D>& vals, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, std::vector<Tensor2D>& vals, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void irecv(int source, unsigned long& val, int tag = MPI_ANY_TAG) const;
+    void irecv(int source, unsigned long& val, Requests &requests, int tag = MPI_ANY_TAG) const;
 
-    void waitAll() const;
+    void waitAll(Requests &requests) const;
+
+    bool testAll(Requests &requests) const;
+
+    //- Funneled overlap. The master thread progresses the requests while the remaining threads
+    //- execute work(i) for i in [0, n), then joins the work once the requests are complete
+    template<class Work>
+    void overlap(Requests &requests, Size n, const Work &work) const;
+
+    //- Distributed graph topology. Ranks may be reordered by the MPI library, so the result should only be
+    //- used for neighbourhood collectives
+    std::shared_ptr<Communicator> createDistGraph(const std::vector<int> &sources,
+                                                  const std::vector<int> &destinations,
+                                                  bool reorder = true) const;
+
+    //- Communicator of the ranks that can share memory with this rank (ie on the same node)
+    std::shared_ptr<Communicator> splitShared() const;
+
+    //- Separate communication context over the same ranks, eg for collectives issued from another thread
+    std::shared_ptr<Communicator> duplicate() const;
+
+    //- Neighbourhood collectives, counts and displacements are ordered by the graph sources/destinations
+    //- and must remain valid until the requests are complete
+    void ineighbourAllToAllv(const std::vector<int> &sendBuffer, const std::vector<int> &sendCounts,
+                             const std::vector<int> &sendDispls, std::vector<int> &recvBuffer,
+                             const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                             Requests &requests) const;
+
+    void ineighbourAllToAllv(const std::vector<unsigned long> &sendBuffer, const std::vector<int> &sendCounts,
+                             const std::vector<int> &sendDispls, std::vector<unsigned long> &recvBuffer,
+                             const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                             Requests &requests) const;
+
+    void ineighbourAllToAllv(const std::vector<double> &sendBuffer, const std::vector<int> &sendCounts,
+                             const std::vector<int> &sendDispls, std::vector<double> &recvBuffer,
+                             const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                             Requests &requests) const;
+
+    void ineighbourAllToAllv(const std::vector<Vector2D> &sendBuffer, const std::vector<int> &sendCounts,
+                             const std::vector<int> &sendDispls, std::vector<Vector2D> &recvBuffer,
+                             const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                             Requests &requests) const;
+
+    void ineighbourAllToAllv(const std::vector<Tensor2D> &sendBuffer, const std::vector<int> &sendCounts,
+                             const std::vector<int> &sendDispls, std::vector<Tensor2D> &recvBuffer,
+                             const std::vector<int> &recvCounts, const std::vector<int> &recvDispls,
+                             Requests &requests) const;
 
     //- Dynamic
 
@@ -133,18 +215,29 @@ public:
 
     Vector2D sum(const Vector2D& val) const;
 
+    //- Element-wise sums
+    std::vector<double> sum(const std::vector<double>& vals) const;
+
+    std::vector<Vector2D> sum(const std::vector<Vector2D>& vals) const;
+
     int min(int val) const;
 
     double min(double val) const;
 
+    int max(int val) const;
+
     double max(double val) const;
 
 private:
 
     static MPI_Datatype MPI_VECTOR2D_, MPI_TENSOR2D_;
 
+    static int threadSupport_;
+
     MPI_Comm comm_;
-    mutable std::vector<MPI_Request> currentRequests_;
+    bool ownsComm_ = false;
 };
 
+#include "Communicator.tpp"
+
 #endif
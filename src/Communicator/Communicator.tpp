@@ -0,0 +1,31 @@
+#include <thread>
+
+#include "Communicator.h"
+
+template<class Work>
+void Communicator::overlap(Requests &requests, Size n, const Work &work) const
+{
+    //- Only the master thread may call MPI under MPI_THREAD_FUNNELED
+    if (threadSupport_ < MPI_THREAD_FUNNELED || n == 0)
+    {
+        for (Size i = 0; i < n; ++i)
+            work(i);
+
+        waitAll(requests);
+        return;
+    }
+
+    #pragma omp parallel
+    {
+        //- Testing drives progress in most MPI libraries, yielding between tests leaves the core to the workers
+        #pragma omp master
+        {
+            while (!testAll(requests))
+                std::this_thread::yield();
+        }
+
+        #pragma omp for schedule(dynamic, 256)
+        for (Size i = 0; i < n; ++i)
+            work(i);
+    }
+}
@@ -0,0 +1,125 @@
+#include "Reduction.h"
+#include "Exception.h"
+
+Reduction::Reduction(const Communicator &comm)
+        :
+        comm_(comm)
+{
+
+}
+
+Size Reduction::add(Scalar val, Op op)
+{
+    if (pending_)
+        throw Exception("Reduction", "add", "cannot add to a reduction in progress.");
+
+    ops_.push_back(op);
+    vals_.push_back(val);
+
+    return vals_.size() - 1;
+}
+
+Size Reduction::add(const Vector2D &val, Op op)
+{
+    Size handle = add(val.x, op);
+    add(val.y, op);
+
+    return handle;
+}
+
+void Reduction::reduce()
+{
+    pack();
+
+    for (Op op: {MAX, MIN, SUM})
+        if (!buffers_[op].empty())
+            MPI_Allreduce(MPI_IN_PLACE, buffers_[op].data(), buffers_[op].size(), MPI_DOUBLE, mpiOp(op),
+                          comm_.communicator());
+
+    unpack();
+}
+
+void Reduction::ireduce()
+{
+    if (pending_)
+        throw Exception("Reduction", "ireduce", "a reduction is already in progress.");
+
+    pack();
+
+    for (Op op: {MAX, MIN, SUM})
+        if (!buffers_[op].empty())
+            MPI_Iallreduce(MPI_IN_PLACE, buffers_[op].data(), buffers_[op].size(), MPI_DOUBLE, mpiOp(op),
+                           comm_.communicator(), &requests_[op]);
+
+    pending_ = true;
+}
+
+void Reduction::wait()
+{
+    if (!pending_)
+        return;
+
+    MPI_Waitall(3, requests_, MPI_STATUSES_IGNORE);
+    pending_ = false;
+    unpack();
+}
+
+Scalar Reduction::scalar(Size handle) const
+{
+    if (pending_)
+        throw Exception("Reduction", "scalar", "reduction has not been completed.");
+
+    return vals_[handle];
+}
+
+Vector2D Reduction::vector(Size handle) const
+{
+    if (pending_)
+        throw Exception("Reduction", "vector", "reduction has not been completed.");
+
+    return Vector2D(vals_[handle], vals_[handle + 1]);
+}
+
+void Reduction::clear()
+{
+    wait();
+    ops_.clear();
+    vals_.clear();
+
+    for (auto &buffer: buffers_)
+        buffer.clear();
+}
+
+//- Private methods
+
+MPI_Op Reduction::mpiOp(Op op)
+{
+    switch (op)
+    {
+        case MAX:
+            return MPI_MAX;
+        case MIN:
+            return MPI_MIN;
+        case SUM:
+            return MPI_SUM;
+    }
+
+    return MPI_OP_NULL;
+}
+
+void Reduction::pack()
+{
+    for (Op op: {MAX, MIN, SUM})
+        buffers_[op].clear();
+
+    for (Size i = 0; i < vals_.size(); ++i)
+        buffers_[ops_[i]].push_back(vals_[i]);
+}
+
+void Reduction::unpack()
+{
+    Size j[3] = {0, 0, 0};
+
+    for (Size i = 0; i < vals_.size(); ++i)
+        vals_[i] = buffers_[ops_[i]][j[ops_[i]]++];
+}
@@ -0,0 +1,59 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "Communicator.h"
+
+//- Batches several global reductions into one allreduce per operation
+class Reduction
+{
+public:
+
+    enum Op
+    {
+        MAX, MIN, SUM
+    };
+
+    Reduction(const Communicator &comm);
+
+    //- Register a local value, returns a handle for retrieving the reduced result
+    Size add(Scalar val, Op op);
+
+    Size add(const Vector2D &val, Op op);
+
+    //- Complete all registered reductions (blocking)
+    void reduce();
+
+    //- Start all registered reductions (non-blocking), must be completed with wait()
+    void ireduce();
+
+    void wait();
+
+    //- Results
+    Scalar scalar(Size handle) const;
+
+    Vector2D vector(Size handle) const;
+
+    //- Remove all registered reductions
+    void clear();
+
+private:
+
+    static MPI_Op mpiOp(Op op);
+
+    void pack();
+
+    void unpack();
+
+    const Communicator &comm_;
+
+    std::vector<Op> ops_;
+    std::vector<Scalar> vals_;
+
+    //- One contiguous section per operation, indexed by Op
+    std::vector<Scalar> buffers_[3];
+    MPI_Request requests_[3] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+    bool pending_ = false;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "SharedWindow.h"
+
+SharedWindow::SharedWindow(const Communicator &nodeComm, Size nBytes)
+        :
+        nodeComm_(nodeComm),
+        rank_(nodeComm.rank()),
+        segments_(nodeComm.nProcs())
+{
+    char *base;
+    MPI_Win_allocate_shared(nBytes, 1, MPI_INFO_NULL, nodeComm_.communicator(), &base, &win_);
+
+    for (int proc = 0; proc < nodeComm_.nProcs(); ++proc)
+    {
+        MPI_Aint size;
+        int dispUnit;
+        MPI_Win_shared_query(win_, proc, &size, &dispUnit, &segments_[proc]);
+    }
+
+    //- A passive target epoch is held for the lifetime of the window, synchronization is through sync()
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+}
+
+SharedWindow::~SharedWindow()
+{
+    int finalized;
+    MPI_Finalized(&finalized);
+
+    if (!finalized)
+    {
+        MPI_Win_unlock_all(win_);
+        MPI_Win_free(&win_);
+    }
+}
+
+void SharedWindow::sync() const
+{
+    MPI_Win_sync(win_);
+    nodeComm_.barrier();
+    MPI_Win_sync(win_);
+}
@@ -0,0 +1,39 @@
+#ifndef SHARED_WINDOW_H
+#define SHARED_WINDOW_H
+
+#include "Communicator.h"
+
+//- A memory segment on each rank of a shared memory (node) communicator, directly readable by the other ranks
+class SharedWindow
+{
+public:
+
+    SharedWindow(const Communicator &nodeComm, Size nBytes);
+
+    SharedWindow(const SharedWindow &other) = delete;
+
+    ~SharedWindow();
+
+    SharedWindow &operator=(const SharedWindow &other) = delete;
+
+    //- Segment owned by this rank
+    char *data()
+    { return segments_[rank_]; }
+
+    //- Segment owned by another rank on the node
+    const char *data(int nodeRank) const
+    { return segments_[nodeRank]; }
+
+    //- Make local writes visible to the other ranks on the node and wait for theirs (collective)
+    void sync() const;
+
+private:
+
+    const Communicator &nodeComm_;
+    int rank_;
+
+    MPI_Win win_;
+    std::vector<char *> segments_;
+};
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef FINITE_VOLUME_FIELD
 #define FINITE_VOLUME_FIELD
 
+#include <iosfwd>
+
 #include "Field.h"
+#include "Checkpoint.h"
 #include "FiniteVolumeGrid2D.h"
 #include "Input.h"
 #include "Vector.h"
@@ -199,6 +202,19 @@ public:
 
     void clearHistory();
 
+    //- Redistribution, the field (and its history) is staged before the grid is repartitioned and migrated after
+    virtual void beginRedistribution();
+
+    virtual void endRedistribution();
+
+    //- Checkpointing, cell/face/node values and the time step history in local ordering
+    void writeCheckpoint(std::ostream &os) const;
+
+    void readCheckpoint(std::istream &is);
+
+    //- Read the slice of the checkpoints of another decomposition assigned to this proc, and redistribute it
+    void readCheckpoint(const std::vector<std::istream *> &streams, const CheckpointRedistribution &redistribution);
+
     FiniteVolumeField &oldField(int i)
     { return previousTimeSteps_[i]->second; }
 
@@ -263,6 +279,10 @@ protected:
     std::vector<std::shared_ptr<PreviousField>> previousTimeSteps_;
 
     std::shared_ptr<FiniteVolumeField<T>> previousIteration_;
+
+    //- Data on the previous partition, staged for redistribution
+    bool redistributing_ = false;
+    std::vector<T> stagedCells_, stagedFaces_, stagedNodes_;
 };
 
 #include "FiniteVolumeField.tpp"
@@ -1,5 +1,6 @@
 #include "FiniteVolumeField.h"
 #include "Exception.h"
+#include "BinaryStream.h"
 
 #include <boost/algorithm/string.hpp>
 #include <fstream>
@@ -174,6 +175,152 @@ void FiniteVolumeField<T>::clearHistory()
     previousTimeSteps_.clear();
 }
 
+template<class T>
+void FiniteVolumeField<T>::beginRedistribution()
+{
+    if (redistributing_)
+        return;
+
+    stagedCells_ = *this;
+    stagedFaces_ = faces_;
+    stagedNodes_ = nodes_;
+
+    for (auto &prevTimeStep: previousTimeSteps_)
+        prevTimeStep->second.beginRedistribution();
+
+    if (previousIteration_)
+        previousIteration_->beginRedistribution();
+
+    redistributing_ = true;
+}
+
+template<class T>
+void FiniteVolumeField<T>::endRedistribution()
+{
+    if (!redistributing_)
+        return;
+
+    std::vector<T> cells = grid_->migrateCellData(stagedCells_);
+    std::vector<T>::assign(cells.begin(), cells.end());
+
+    if (!stagedFaces_.empty())
+        faces_ = grid_->migrateFaceData(stagedFaces_);
+
+    if (!stagedNodes_.empty())
+        nodes_ = grid_->migrateNodeData(stagedNodes_);
+
+    stagedCells_.clear();
+    stagedFaces_.clear();
+    stagedNodes_.clear();
+
+    for (auto &prevTimeStep: previousTimeSteps_)
+        prevTimeStep->second.endRedistribution();
+
+    if (previousIteration_)
+        previousIteration_->endRedistribution();
+
+    redistributing_ = false;
+}
+
+template<class T>
+void FiniteVolumeField<T>::writeCheckpoint(std::ostream &os) const
+{
+    writeBinary(os, static_cast<const std::vector<T> &>(*this));
+    writeBinary(os, faces_);
+    writeBinary(os, nodes_);
+    writeBinary(os, (unsigned long) previousTimeSteps_.size());
+
+    for (const auto &prevTimeStep: previousTimeSteps_)
+    {
+        writeBinary(os, prevTimeStep->first);
+        prevTimeStep->second.writeCheckpoint(os);
+    }
+}
+
+template<class T>
+void FiniteVolumeField<T>::readCheckpoint(std::istream &is)
+{
+    readBinary(is, static_cast<std::vector<T> &>(*this));
+    readBinary(is, faces_);
+    readBinary(is, nodes_);
+
+    if (this->size() != grid_->nCells()
+        || !(faces_.empty() || faces_.size() == grid_->nFaces())
+        || !(nodes_.empty() || nodes_.size() == grid_->nNodes()))
+        throw Exception("FiniteVolumeField", "readCheckpoint", "checkpoint of field \"" + this->name_
+                                                               + "\" does not match the grid.");
+
+    unsigned long nPreviousTimeSteps;
+    readBinary(is, nPreviousTimeSteps);
+
+    previousTimeSteps_.clear();
+    previousIteration_ = nullptr;
+
+    for (int i = 0; i < nPreviousTimeSteps; ++i)
+    {
+        Scalar timeStep;
+        readBinary(is, timeStep);
+
+        auto prevTimeStep = std::make_shared<PreviousField>(timeStep, *this);
+        prevTimeStep->second.clearHistory();
+        prevTimeStep->second.readCheckpoint(is);
+        previousTimeSteps_.push_back(prevTimeStep);
+    }
+}
+
+template<class T>
+void FiniteVolumeField<T>::readCheckpoint(const std::vector<std::istream *> &streams,
+                                          const CheckpointRedistribution &redistribution)
+{
+    const Communicator &comm = redistribution.comm();
+
+    //- Entries of all checkpoints read by this proc, in the order of their ids
+    auto read = [&streams]() {
+        std::vector<T> vals, streamVals;
+
+        for (std::istream *is: streams)
+        {
+            readBinary(*is, streamVals);
+            vals.insert(vals.end(), streamVals.begin(), streamVals.end());
+        }
+
+        return vals;
+    };
+
+    std::vector<T> cells = read(), faces = read(), nodes = read();
+
+    cells = redistribution.cellData(cells);
+    std::vector<T>::assign(cells.begin(), cells.end());
+
+    //- The main proc always reads the first checkpoint, so it decides which data is present
+    if (comm.broadcast(comm.mainProcNo(), (int) !faces.empty()))
+        faces_ = redistribution.faceData(faces);
+
+    if (comm.broadcast(comm.mainProcNo(), (int) !nodes.empty()))
+        nodes_ = redistribution.nodeData(nodes);
+
+    unsigned long nPreviousTimeSteps = 0;
+    for (std::istream *is: streams)
+        readBinary(*is, nPreviousTimeSteps);
+
+    nPreviousTimeSteps = comm.broadcast(comm.mainProcNo(), (int) nPreviousTimeSteps);
+
+    previousTimeSteps_.clear();
+    previousIteration_ = nullptr;
+
+    for (int i = 0; i < nPreviousTimeSteps; ++i)
+    {
+        Scalar timeStep = 0.;
+        for (std::istream *is: streams)
+            readBinary(*is, timeStep);
+
+        auto prevTimeStep = std::make_shared<PreviousField>(comm.broadcast(comm.mainProcNo(), timeStep), *this);
+        prevTimeStep->second.clearHistory();
+        prevTimeStep->second.readCheckpoint(streams, redistribution);
+        previousTimeSteps_.push_back(prevTimeStep);
+    }
+}
+
 template<class T>
 Vector FiniteVolumeField<T>::vectorize() const
 {
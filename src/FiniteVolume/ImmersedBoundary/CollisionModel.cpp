@@ -1,49 +1,261 @@
 #include <algorithm>
+#include <numeric>
+#include <limits>
 
 #include "CollisionModel.h"
 
+namespace
+{
+    //- A convex shape as the Minkowski sum of a convex polygon (or a point) and a disc
+    struct ConvexShape
+    {
+        std::vector<Point2D> vertices;
+        Scalar radius;
+    };
+
+    ConvexShape convexShape(const Shape2D &shape)
+    {
+        switch (shape.type())
+        {
+            case Shape2D::CIRCLE:
+                return ConvexShape{std::vector<Point2D>(1, shape.centroid()),
+                                   static_cast<const Circle &>(shape).radius()};
+            case Shape2D::BOX:
+            {
+                auto vertices = static_cast<const Box &>(shape).vertices();
+                return ConvexShape{std::vector<Point2D>(vertices.begin(), vertices.end()), 0.};
+            }
+            case Shape2D::POLYGON:
+            {
+                //- Non-convex polygons are replaced by their convex hull
+                std::vector<Point2D> vertices = static_cast<const Polygon &>(shape).vertices();
+                vertices = Polygon::convexHull(vertices.begin(), vertices.end()).vertices();
+
+                if (vertices.size() > 1 && vertices.front() == vertices.back())
+                    vertices.pop_back();
+
+                return ConvexShape{vertices, 0.};
+            }
+            default:
+                throw Exception("CollisionModel", "convexShape", "shape type not supported.");
+        }
+    }
+
+    void addEdgeNormals(const ConvexShape &shape, std::vector<Vector2D> &axes)
+    {
+        if (shape.vertices.size() < 2)
+            return;
+
+        for (Label i = 0; i < shape.vertices.size(); ++i)
+        {
+            Vector2D edge = shape.vertices[(i + 1) % shape.vertices.size()] - shape.vertices[i];
+
+            if (edge.magSqr() > 0.)
+                axes.push_back(edge.normalVec().unitVec());
+        }
+    }
+
+    //- Axis from a disc centre to the nearest vertex of the other shape, the only other candidate separating axis
+    void addVertexAxis(const ConvexShape &disc, const ConvexShape &shape, std::vector<Vector2D> &axes)
+    {
+        if (disc.vertices.size() != 1)
+            return;
+
+        const Point2D &c = disc.vertices[0];
+        auto nearest = std::min_element(shape.vertices.begin(), shape.vertices.end(),
+                                        [&c](const Point2D &a, const Point2D &b) {
+                                            return (a - c).magSqr() < (b - c).magSqr();
+                                        });
+
+        if ((*nearest - c).magSqr() > 0.)
+            axes.push_back((*nearest - c).unitVec());
+    }
+
+    std::pair<Scalar, Scalar> project(const ConvexShape &shape, const Vector2D &axis)
+    {
+        Scalar lower = std::numeric_limits<Scalar>::infinity(), upper = -lower;
+
+        for (const Point2D &vtx: shape.vertices)
+        {
+            lower = std::min(lower, dot(vtx, axis));
+            upper = std::max(upper, dot(vtx, axis));
+        }
+
+        return std::make_pair(lower - shape.radius, upper + shape.radius);
+    }
+
+    //- Penetration depth and the contact normal pointing towards p. The depth is negative for separated shapes, in which
+    //- case it is a lower bound of the separation
+    std::pair<Scalar, Vector2D> contact(const Shape2D &shapeP, const Shape2D &shapeQ)
+    {
+        ConvexShape p = convexShape(shapeP), q = convexShape(shapeQ);
+        std::vector<Vector2D> axes;
+
+        addEdgeNormals(p, axes);
+        addEdgeNormals(q, axes);
+        addVertexAxis(p, q, axes);
+        addVertexAxis(q, p, axes);
+
+        Scalar depth = std::numeric_limits<Scalar>::infinity();
+        Vector2D normal(0., 0.);
+
+        for (const Vector2D &axis: axes)
+        {
+            auto projP = project(p, axis), projQ = project(q, axis);
+            Scalar overlap = std::min(projP.second, projQ.second) - std::max(projP.first, projQ.first);
+
+            if (overlap < depth)
+            {
+                depth = overlap;
+                normal = dot(axis, shapeP.centroid() - shapeQ.centroid()) < 0. ? -axis : axis;
+            }
+        }
+
+        return std::make_pair(depth, normal);
+    }
+}
+
 CollisionModel::CollisionModel(Scalar eps, Scalar range)
 {
     eps_ = eps;
     range_ = range;
 }
 
+std::vector<Vector2D> CollisionModel::forces(const std::vector<std::shared_ptr<ImmersedBoundaryObject>> &ibObjs,
+                                             const FiniteVolumeGrid2D &grid) const
+{
+    typedef boost::geometry::model::box<Point2D> Box2D;
+
+    std::vector<Box2D> boxes;
+    std::vector<Label> order(ibObjs.size());
+
+    for (const auto &ibObj: ibObjs)
+        boxes.push_back(ibObj->shape().boundingBox());
+
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&boxes](Label i, Label j) {
+        return boxes[i].min_corner().x < boxes[j].min_corner().x;
+    });
+
+    //- Sweep and prune along x, the active objects are those whose boxes are within range of the sweep line
+    std::vector<Vector2D> fc(ibObjs.size(), Vector2D(0., 0.));
+    std::vector<Label> active;
+
+    for (Label i: order)
+    {
+        active.erase(std::remove_if(active.begin(), active.end(), [this, &boxes, i](Label j) {
+            return boxes[j].max_corner().x + range_ < boxes[i].min_corner().x;
+        }), active.end());
+
+        for (Label j: active)
+            if (boxes[j].min_corner().y <= boxes[i].max_corner().y + range_
+                && boxes[i].min_corner().y <= boxes[j].max_corner().y + range_)
+            {
+                Vector2D f = force(*ibObjs[i], *ibObjs[j]);
+                fc[i] += f;
+                fc[j] -= f;
+            }
+
+        active.push_back(i);
+    }
+
+    //- Wall forces of all objects are reduced together
+    std::vector<Vector2D> fw;
+
+    for (const auto &ibObj: ibObjs)
+        fw.push_back(localWallForce(*ibObj, grid));
+
+    fw = grid.comm().sum(fw);
+
+    for (Label i = 0; i < ibObjs.size(); ++i)
+        fc[i] += fw[i];
+
+    return fc;
+}
+
 Vector2D CollisionModel::force(const ImmersedBoundaryObject &ibObjP, const ImmersedBoundaryObject &ibObjQ) const
 {
+    if (&ibObjP == &ibObjQ)
+        return Vector2D(0., 0.);
+
+    const Vector2D &xp = ibObjP.shape().centroid();
+    const Vector2D &xq = ibObjQ.shape().centroid();
+    Scalar d = (xp - xq).mag();
+
     if (ibObjP.shape().type() == Shape2D::CIRCLE && ibObjQ.shape().type() == Shape2D::CIRCLE)
     {
-        const Circle &c1 = static_cast<const Circle &>(ibObjP.shape());
-        const Circle &c2 = static_cast<const Circle &>(ibObjQ.shape());
-        const Vector2D &xp = c1.centroid();
-        const Vector2D &xq = c2.centroid();
-        Scalar r1 = c1.radius();
-        Scalar r2 = c2.radius();
-
-        Scalar d = (xp - xq).mag();
+        Scalar r1 = static_cast<const Circle &>(ibObjP.shape()).radius();
+        Scalar r2 = static_cast<const Circle &>(ibObjQ.shape()).radius();
 
         return d > r1 + r2 + range_ ? Vector2D(0., 0.) : (xp - xq) / eps_ * pow(r1 + r2 + range_ - d, 2);
     }
+
+    //- Same law as for circles, with the separating axis as the direction of the force
+    auto c = contact(ibObjP.shape(), ibObjQ.shape());
+
+    return c.first + range_ < 0. ? Vector2D(0., 0.) : c.second * d / eps_ * pow(c.first + range_, 2);
 }
 
 Vector2D CollisionModel::force(const ImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid) const
+{
+    return grid.comm().sum(localWallForce(ibObj, grid));
+}
+
+void CollisionModel::clearWallFaces()
+{
+    wallFaces_.clear();
+}
+
+//- Private methods
+
+Vector2D CollisionModel::localWallForce(const ImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid) const
 {
     Vector2D fc = Vector2D(0., 0.);
+    const Vector2D &xp = ibObj.shape().centroid();
 
-    if (ibObj.shape().type() == Shape2D::CIRCLE)
+    for (const Face &f: wallFaces(ibObj, grid))
     {
-        const Circle &c = static_cast<const Circle &>(ibObj.shape());
-        const Vector2D &xp = c.centroid();
-        Scalar r = c.radius();
+        const Vector2D &xq = f.centroid();
+        Scalar dist;
 
-        for (const Patch &p: grid.patches())
-            for (const Face &f: p.itemsCoveredBy(Circle(c.centroid(), r + range_)))
-            {
-                const Vector2D &xq = f.centroid();
-                Scalar d = (xp - xq).mag();
+        //- Signed distance of the face from the object
+        if (ibObj.shape().type() == Shape2D::CIRCLE)
+            dist = (xp - xq).mag() - static_cast<const Circle &>(ibObj.shape()).radius();
+        else
+        {
+            dist = (ibObj.nearestIntersect(xq) - xq).mag();
+            dist = ibObj.isInIb(xq) ? -dist : dist;
+        }
 
-                fc += (xp - xq) / eps_ * pow(r + range_ - d, 2);
-            }
+        if (dist <= range_)
+            fc += (xp - xq) / eps_ * pow(range_ - dist, 2);
     }
 
-    return grid.comm().sum(fc);
-}
\ No newline at end of file
+    return fc;
+}
+
+const std::vector<Ref<const Face>> &CollisionModel::wallFaces(const ImmersedBoundaryObject &ibObj,
+                                                              const FiniteVolumeGrid2D &grid) const
+{
+    auto it = wallFaces_.find(ibObj.id());
+    const Point2D &pos = ibObj.shape().centroid();
+
+    if (it != wallFaces_.end() && (pos - it->second.pos).mag() <= it->second.margin)
+        return it->second.faces;
+
+    //- Faces are gathered within a margin of the range, a quarter of the object size, over any orientation
+    auto box = ibObj.shape().boundingBox();
+    Scalar radius = std::max((box.min_corner() - pos).mag(), (box.max_corner() - pos).mag());
+    Scalar margin = radius / 4.;
+
+    WallFaces &wallFaces = wallFaces_[ibObj.id()];
+    wallFaces.pos = pos;
+    wallFaces.margin = margin;
+    wallFaces.faces.clear();
+
+    for (const Patch &p: grid.patches())
+        for (const Face &f: p.itemsCoveredBy(Circle(pos, radius + range_ + margin)))
+            wallFaces.faces.push_back(std::cref(f));
+
+    return wallFaces.faces;
+}
@@ -3,19 +3,45 @@
 
 #include "ImmersedBoundaryObject.h"
 
+//- Soft-sphere collision forces between immersed boundary objects and with the domain boundary. Candidate pairs are
+//- found by sweep and prune over the object bounding boxes, and contacts between circles, boxes and polygons are
+//- resolved with the separating axis theorem (non-convex polygons are treated as their convex hull)
 class CollisionModel
 {
 public:
 
     CollisionModel(Scalar eps, Scalar range = 0.);
 
+    //- Collision forces on all objects, from each other and from the domain boundary
+    std::vector<Vector2D> forces(const std::vector<std::shared_ptr<ImmersedBoundaryObject>> &ibObjs,
+                                 const FiniteVolumeGrid2D &grid) const;
+
     virtual Vector2D force(const ImmersedBoundaryObject& ibObjP, const ImmersedBoundaryObject& ibObjQ) const;
 
     virtual Vector2D force(const ImmersedBoundaryObject& ibObj, const FiniteVolumeGrid2D& grid) const;
 
+    //- Must be called before the faces of the grid are destroyed
+    void clearWallFaces();
+
 private:
 
+    //- Boundary faces near an object, reused until it has moved by more than the margin
+    struct WallFaces
+    {
+        Point2D pos;
+        Scalar margin;
+        std::vector<Ref<const Face>> faces;
+    };
+
+    //- Force from the boundary faces on this proc
+    Vector2D localWallForce(const ImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid) const;
+
+    const std::vector<Ref<const Face>> &wallFaces(const ImmersedBoundaryObject &ibObj,
+                                                  const FiniteVolumeGrid2D &grid) const;
+
     Scalar eps_, range_;
+
+    mutable std::unordered_map<Label, WallFaces> wallFaces_;
 };
 
 
@@ -1,6 +1,9 @@
 #include <tuple>
+#include <unordered_set>
 
 #include "GhostCellImmersedBoundaryObject.h"
+#include "BatchedMatrix.h"
+#include "Box.h"
 
 GhostCellImmersedBoundaryObject::GhostCellImmersedBoundaryObject(const std::string &name, Label id,
                                                                  FiniteVolumeGrid2D &grid)
@@ -12,46 +15,81 @@ GhostCellImmersedBoundaryObject::GhostCellImmersedBoundaryObject(const std::stri
 
 void GhostCellImmersedBoundaryObject::updateCells()
 {
-    if (motion_)
+    freshCells_.clear();
+    deadCells_.clear();
+
+    //- Cells whose inactive status may have changed
+    std::vector<Ref<const Cell>> cells;
+
+    //- Objects that have no cells on this proc are located from scratch, since there is no band to search from
+    if (ibCells_.empty())
     {
-//        fluid_->add(freshCells_);
-//        freshCells_.clear();
-//
-//        for (const Cell &cell: cells_)
-//            if (!isInIb(cell.centroid()))
-//                freshCells_.add(cell);
+        stencils_.clear(); //- May refer to the cells of a previous grid
+        fluid_->add(cells_);
+        solidCells_.clear();
+
+        for (Label id: inactiveCells_)
+            cells.push_back(std::cref(grid_.cells()[id]));
+
+        auto located = fluid_->itemsWithin(*shapePtr_);
+        cells_.addAll(located);
+        classifyCells(located);
+
+        cells.insert(cells.end(), solidCells_.begin(), solidCells_.end());
     }
+    else
+    {
+        for (const GhostCellStencil &st: stencils_)
+            cells.insert(cells.end(), st.cells().begin(), st.cells().end());
 
-    fluid_->add(cells_);
+        classifyCells(bandCells());
+    }
 
-    ibCells_.clear();
-    solidCells_.clear();
-    deadCells_.clear();
+    position0_ = position();
+    theta0_ = theta();
 
-    cells_.addAll(fluid_->itemsWithin(*shapePtr_));
+    constructStencils();
 
-    auto isIbCell = [this](const Cell &cell) {
-        if (!isInIb(cell.centroid()))
-            return false;
+    //- Otherwise only cells linked to cells that entered or left the object, and the old and new stencil cells, can
+    //- have changed
+    for (const CellZone &zone: {std::cref(freshCells_), std::cref(deadCells_)})
+        for (const Cell &cell: zone)
+        {
+            cells.push_back(std::cref(cell));
 
-        for (const InteriorLink &nb: cell.neighbours())
-            if (!isInIb(nb.cell().centroid()))
-                return true;
+            for (const CellLink &nb: cell.cellLinks())
+                cells.push_back(std::cref(nb.cell()));
+        }
 
-        for (const CellLink &dg: cell.diagonals())
-            if (!isInIb(dg.cell().centroid()))
-                return true;
+    for (const GhostCellStencil &st: stencils_)
+        cells.insert(cells.end(), st.cells().begin(), st.cells().end());
 
-        return false;
-    };
+    updateInactiveCells(cells);
+}
 
-    for (const Cell &cell: cells_)
-        if (isIbCell(cell))
-            ibCells_.add(cell);
-        else
-            solidCells_.add(cell);
+void GhostCellImmersedBoundaryObject::updateInactiveCells(const std::vector<Ref<const Cell>> &cells)
+{
+    deactivatedCells_.clear();
+    reactivatedCells_.clear();
 
-    constructStencils();
+    std::unordered_set<Label> stencilCells;
+
+    for (const GhostCellStencil &st: stencils_)
+        for (const Cell &cell: st.cells())
+            stencilCells.insert(cell.id());
+
+    for (const Cell &cell: cells)
+    {
+        bool isInactive = solidCells_.isInGroup(cell) && stencilCells.find(cell.id()) == stencilCells.end();
+
+        for (const CellLink &nb: cell.cellLinks())
+            isInactive = isInactive && cells_.isInGroup(nb.cell());
+
+        if (isInactive && inactiveCells_.insert(cell.id()).second)
+            deactivatedCells_.push_back(std::cref(cell));
+        else if (!isInactive && inactiveCells_.erase(cell.id()))
+            reactivatedCells_.push_back(std::cref(cell));
+    }
 }
 
 Equation <Scalar> GhostCellImmersedBoundaryObject::bcs(ScalarFiniteVolumeField &field) const
@@ -70,10 +108,7 @@ Equation <Scalar> GhostCellImmersedBoundaryObject::bcs(ScalarFiniteVolumeField &
             }
 
             for (const Cell &cell: solidCells_)
-            {
-                eqn.add(cell, cell, 1.);
-                eqn.addSource(cell, -bRefValue);
-            }
+                fixSolidCell(eqn, field, cell, bRefValue);
 
             break;
         case NORMAL_GRADIENT:
@@ -84,7 +119,7 @@ Equation <Scalar> GhostCellImmersedBoundaryObject::bcs(ScalarFiniteVolumeField &
             }
 
             for (const Cell &cell: solidCells_)
-                eqn.add(cell, cell, 1.);
+                fixSolidCell(eqn, field, cell, 0.);
             break;
 
         default:
@@ -121,10 +156,7 @@ Equation <Vector2D> GhostCellImmersedBoundaryObject::bcs(VectorFiniteVolumeField
     }
 
     for (const Cell &cell: solidCells_)
-    {
-        eqn.add(cell, cell, 1.);
-        eqn.addSource(cell, -bRefValue);
-    }
+        fixSolidCell(eqn, field, cell, Vector2D(bRefValue));
 
     return eqn;
 }
@@ -147,10 +179,7 @@ Equation <Vector2D> GhostCellImmersedBoundaryObject::velocityBcs(VectorFiniteVol
     }
 
     for (const Cell &cell: solidCells_)
-    {
-        eqn.add(cell, cell, 1.);
-        eqn.addSource(cell, -velocity(cell.centroid()));
-    }
+        fixSolidCell(eqn, u, cell, velocity(cell.centroid()));
 
     return eqn;
 }
@@ -169,10 +198,8 @@ Equation <Scalar> GhostCellImmersedBoundaryObject::pressureBcs(Scalar rho, Scala
             eqn.addSource(st.cell(), rho * dUdN);
         }
 
-    for (const Cell &cell: solidCells())
-    {
-        eqn.add(cell, cell, 1.);
-    }
+    for (const Cell &cell: solidCells_)
+        fixSolidCell(eqn, p, cell, 0.);
 
     return eqn;
 }
@@ -208,81 +235,211 @@ Equation <Scalar> GhostCellImmersedBoundaryObject::contactLineBcs(ScalarFiniteVo
     }
 
     for (const Cell &cell: solidCells_)
-        eqn.add(cell, cell, 1.);
+        fixSolidCell(eqn, gamma, cell, 0.);
 
     return eqn;
 }
 
 //- Force computation
 
-void GhostCellImmersedBoundaryObject::computeForce(Scalar rho,
-                                                   Scalar mu,
+void GhostCellImmersedBoundaryObject::stencilForce(const GhostCellStencil &st,
+                                                   const Viscosity &mu,
                                                    const VectorFiniteVolumeField &u,
                                                    const ScalarFiniteVolumeField &p,
-                                                   const Vector2D &g)
+                                                   Vector2D &force,
+                                                   Scalar &torque) const
 {
-    std::vector <Point2D> points;
-    std::vector <Scalar> pressures;
-    std::vector <Scalar> shears;
+    force = Vector2D(0., 0.);
+    torque = 0.;
 
-    for (const GhostCellStencil &st: stencils_)
+    const Vector2D &nw = st.wallNormal();
+    Scalar pb = st.bpValue(p);
+    Scalar dUdN = dot(dot(st.bpGrad(u), nw), nw.tangentVec());
+
+    for (const InteriorLink &nb: st.cell().neighbours())
     {
-        points.push_back(st.boundaryPoint());
-        pressures.push_back(st.bpValue(p));
-        shears.push_back(mu * dot(dot(st.bpGrad(u), st.wallNormal()), st.wallNormal().tangentVec()));
+        if (cells_.isInGroup(nb.cell()))
+            continue;
+
+        Point2D ptA = nearestIntersect(nb.face().lNode());
+        Point2D ptB = nearestIntersect(nb.face().rNode());
+
+        //- Orient the segment so that its normal points out of the object
+        Vector2D sf = dot((ptB - ptA).normalVec(), nb.outwardNorm()) < 0. ? ptA - ptB : ptB - ptA;
+        Vector2D df = -pb * sf.normalVec() + mu(nb.face()) * dUdN * sf;
+
+        force += df;
+        torque += cross((ptA + ptB) / 2. - position(), df);
     }
+}
 
-    points = grid_.comm().gatherv(grid_.comm().mainProcNo(), points);
-    pressures = grid_.comm().gatherv(grid_.comm().mainProcNo(), pressures);
-    shears = grid_.comm().gatherv(grid_.comm().mainProcNo(), shears);
+//- Protected methods
 
-    if (grid_.comm().isMainProc())
-    {
-        force_ = Vector2D(0., 0.);
+std::vector<Ref<const Cell>> GhostCellImmersedBoundaryObject::bandCells() const
+{
+    //- Every cell whose status can have changed is within the boundary displacement plus one link of the new boundary
+    auto box = shapePtr_->boundingBox();
+    Scalar radius = std::max((box.min_corner() - position()).mag(), (box.max_corner() - position()).mag());
+    Scalar width = (position() - position0_).mag() + std::abs(theta() - theta0_) * radius + linkLength_;
+
+    auto isInBand = [this, width](const Cell &cell) {
+        return (fluid_->isInGroup(cell) || cells_.isInGroup(cell))
+               && (cell.centroid() - nearestIntersect(cell.centroid())).mag() <= width;
+    };
+
+    //- The band is found by a search from the previous ib cells
+    std::vector<Ref<const Cell>> band(ibCells_.begin(), ibCells_.end());
+    std::unordered_set<Label> visited;
 
-        std::vector <std::tuple<Point2D, Scalar, Scalar>> stresses(points.size());
-        for (int i = 0; i < points.size(); ++i)
-            stresses[i] = std::make_tuple(points[i], pressures[i], shears[i]);
+    for (const Cell &cell: band)
+        visited.insert(cell.id());
 
-        std::sort(stresses.begin(), stresses.end(),
-                  [this](const std::tuple <Point2D, Scalar, Scalar> &a, std::tuple <Point2D, Scalar, Scalar> &b) {
-                      return (std::get<0>(a) - shapePtr_->centroid()).angle() <
-                             (std::get<0>(b) - shapePtr_->centroid()).angle();
-                  });
+    //- The boundary on this proc need not be connected, a segment can enter from across a partition boundary where
+    //- there are no previous ib cells to reach it from. Cells next to the buffer zones near the object also seed it
+    Box searchBox(Point2D(box.min_corner().x - width - linkLength_, box.min_corner().y - width - linkLength_),
+                  Point2D(box.max_corner().x + width + linkLength_, box.max_corner().y + width + linkLength_));
 
-        for (int i = 0; i < stresses.size(); ++i)
+    for (const CellZone &bufferZone: grid_.bufferZones())
+        for (const Cell &bufferCell: bufferZone.itemsWithin(searchBox))
         {
-            const auto &a = stresses[i];
-            const auto &b = stresses[(i + 1) % stresses.size()];
+            for (const InteriorLink &nb: bufferCell.neighbours())
+                if (!visited.count(nb.cell().id()) && isInBand(nb.cell()))
+                {
+                    visited.insert(nb.cell().id());
+                    band.push_back(std::cref(nb.cell()));
+                }
+
+            for (const CellLink &dg: bufferCell.diagonals())
+                if (!visited.count(dg.cell().id()) && isInBand(dg.cell()))
+                {
+                    visited.insert(dg.cell().id());
+                    band.push_back(std::cref(dg.cell()));
+                }
+        }
 
-            const Point2D &ptA = std::get<0>(a);
-            const Point2D &ptB = std::get<0>(b);
-            Scalar prA = std::get<1>(a);
-            Scalar prB = std::get<1>(b);
-            Scalar shA = std::get<2>(a);
-            Scalar shB = std::get<2>(b);
+    for (Label i = 0; i < band.size(); ++i)
+    {
+        const Cell &cell = band[i];
 
-            force_ += -(prA + prB) / 2. * (ptB - ptA).normalVec() + (shA + shB) / 2. * (ptB - ptA);
-        }
+        for (const InteriorLink &nb: cell.neighbours())
+            if (visited.insert(nb.cell().id()).second && isInBand(nb.cell()))
+                band.push_back(std::cref(nb.cell()));
+
+        for (const CellLink &dg: cell.diagonals())
+            if (visited.insert(dg.cell().id()).second && isInBand(dg.cell()))
+                band.push_back(std::cref(dg.cell()));
     }
 
-    force_ = grid_.comm().broadcast(grid_.comm().mainProcNo(), force_);
+    return band;
 }
 
-void GhostCellImmersedBoundaryObject::computeForce(const ScalarFiniteVolumeField &rho,
-                                                   const ScalarFiniteVolumeField &mu,
-                                                   const VectorFiniteVolumeField &u,
-                                                   const ScalarFiniteVolumeField &p,
-                                                   const Vector2D &g)
+void GhostCellImmersedBoundaryObject::classifyCells(const std::vector<Ref<const Cell>> &cells)
 {
+    //- Zone membership only changes for cells that switched status, since every change updates the zone rtrees
+    for (const Cell &cell: cells)
+    {
+        bool isInside = isInIb(cell);
 
-}
+        if (isInside && !cells_.isInGroup(cell))
+        {
+            cells_.add(cell);
+            deadCells_.add(cell);
+        }
+        else if (!isInside && cells_.isInGroup(cell))
+        {
+            fluid_->add(cell);
+            ibCells_.remove(cell);
+            solidCells_.remove(cell);
+            freshCells_.add(cell);
+        }
+    }
 
-//- Protected methods
+    auto isIbCell = [this](const Cell &cell) {
+        for (const InteriorLink &nb: cell.neighbours())
+            if (!isInIb(nb.cell()))
+                return true;
+
+        for (const CellLink &dg: cell.diagonals())
+            if (!isInIb(dg.cell()))
+                return true;
+
+        return false;
+    };
+
+    for (const Cell &cell: cells)
+    {
+        if (!cells_.isInGroup(cell))
+            continue;
+
+        if (isIbCell(cell))
+        {
+            if (!ibCells_.isInGroup(cell))
+                ibCells_.add(cell);
+
+            for (const InteriorLink &nb: cell.neighbours())
+                linkLength_ = std::max(linkLength_, nb.rCellVec().mag());
+
+            for (const CellLink &dg: cell.diagonals())
+                linkLength_ = std::max(linkLength_, dg.rCellVec().mag());
+        }
+        else if (!solidCells_.isInGroup(cell))
+            solidCells_.add(cell);
+    }
+}
 
 void GhostCellImmersedBoundaryObject::constructStencils()
 {
-    stencils_.clear();
+    //- Stencils are kept for ghost cells that remain, and only updated if the object has moved
+    bool moved = !(position() == stencilPosition_) || theta() != stencilTheta_;
+    std::unordered_map<Label, Label> stencilIds;
+
+    for (Label i = 0; i < stencils_.size(); ++i)
+        stencilIds[stencils_[i].cell().id()] = i;
+
+    std::vector<GhostCellStencil> stencils;
+    std::vector<Label> located, newDonors;
+    stencils.reserve(ibCells_.size());
+
     for (const Cell &cell: ibCells_)
-        stencils_.push_back(GhostCellStencil(cell, *this, grid_));
+    {
+        auto it = stencilIds.find(cell.id());
+
+        if (it == stencilIds.end())
+            stencils.push_back(GhostCellStencil(cell));
+        else
+        {
+            stencils.push_back(std::move(stencils_[it->second]));
+
+            if (!moved)
+                continue;
+        }
+
+        located.push_back(stencils.size() - 1);
+
+        if (stencils.back().locate(*this, grid_))
+            newDonors.push_back(stencils.size() - 1);
+    }
+
+    //- The interpolation matrices of stencils with new donor cells are inverted together
+    BatchedMatrix<4, 4> A(newDonors.size());
+
+    for (Label i = 0; i < newDonors.size(); ++i)
+        A.set(i, stencils[newDonors[i]].donorMatrix());
+
+    A.invert();
+
+    for (Label i = 0; i < newDonors.size(); ++i)
+        stencils[newDonors[i]].setCoeffs(A.get(i));
+
+    for (Label i = 0, j = 0; i < located.size(); ++i)
+    {
+        if (j < newDonors.size() && newDonors[j] == located[i])
+            ++j;
+        else
+            stencils[located[i]].setCoeffs();
+    }
+
+    stencils_ = std::move(stencils);
+    stencilPosition_ = position();
+    stencilTheta_ = theta();
 }
\ No newline at end of file
@@ -30,18 +30,15 @@ public:
 
     Equation<Scalar> contactLineBcs(ScalarFiniteVolumeField &gamma, Scalar theta) const;
 
-    void computeForce(Scalar rho,
-                      Scalar mu,
+    //- Force and torque on the boundary behind the faces a ghost cell shares with fluid cells, the faces are projected
+    //- onto the boundary so that the segments of all ghost cells tile it. Thread safe, the results are not reduced.
+    //- The forces of all ghost cell objects are integrated together by ImmersedBoundary::computeForce
+    void stencilForce(const GhostCellStencil &st,
+                      const Viscosity &mu,
                       const VectorFiniteVolumeField &u,
                       const ScalarFiniteVolumeField &p,
-                      const Vector2D &g = Vector2D(0., 0.));
-
-    void computeForce(const ScalarFiniteVolumeField &rho,
-                      const ScalarFiniteVolumeField &mu,
-                      const VectorFiniteVolumeField &u,
-                      const ScalarFiniteVolumeField &p,
-                      const Vector2D &g = Vector2D(0., 0.));
-
+                      Vector2D &force,
+                      Scalar &torque) const;
 
     const std::vector<GhostCellStencil> &stencils() const
     { return stencils_; }
@@ -53,8 +50,26 @@ protected:
 
     void constructStencils();
 
+    //- Cells near the boundary whose status may have changed since the last update
+    std::vector<Ref<const Cell>> bandCells() const;
+
+    //- Update the zones of cells, moving only those whose status changed
+    void classifyCells(const std::vector<Ref<const Cell>> &cells);
+
+    //- Update the inactive status of the given cells, solid cells that only have ib or solid cells around them and
+    //- are not in a stencil
+    void updateInactiveCells(const std::vector<Ref<const Cell>> &cells);
+
+    //- Configuration at the last update and the longest link of an ib cell, which bound the band
+    Point2D position0_;
+    Scalar theta0_ = 0., linkLength_ = 0.;
+
     std::vector<GhostCellStencil> stencils_;
     std::vector<GhostCellStencil> contactLineStencils_;
+
+    //- Configuration the stencils were constructed at
+    Point2D stencilPosition_;
+    Scalar stencilTheta_ = 0.;
 };
 
 #endif
@@ -7,57 +7,7 @@ GhostCellStencil::GhostCellStencil(const Cell &cell,
         :
         ImmersedBoundaryStencil(cell)
 {
-    bp_ = ibObj.nearestIntersect(cell.centroid());
-    ip_ = 2. * bp_ - cell.centroid();
-    nw_ = ibObj.nearestEdgeNormal(bp_).unitVec();
-    cells_ = grid.findNearestNode(ip_).cells();
-
-    if (cells_.size() != 4)
-        throw Exception("GhostCellStencil", "GhostCellStencil", "number of image point cells must be 4.");
-
-    Point2D x1 = cells_[0].get().centroid();
-    Point2D x2 = cells_[1].get().centroid();
-    Point2D x3 = cells_[2].get().centroid();
-    Point2D x4 = cells_[3].get().centroid();
-
-    bool ghostCellInStencil = false;
-    for (const Cell &cell: cells_)
-        if (cell_.get().id() == cell.id())
-        {
-            ghostCellInStencil = true;
-            break;
-        }
-
-    A_ = inverse<4, 4>(
-            {
-                    x1.x * x1.y, x1.x, x1.y, 1.,
-                    x2.x * x2.y, x2.x, x2.y, 1.,
-                    x3.x * x3.y, x3.x, x3.y, 1.,
-                    x4.x * x4.y, x4.x, x4.y, 1.,
-            });
-
-    if (ghostCellInStencil)
-    {
-        Vector2D n = ibObj.nearestEdgeNormal(bp_).unitVec();
-        auto xd = StaticMatrix<1, 4>({bp_.x * bp_.y, bp_.x, bp_.y, 1.}) * A_;
-        auto xn = StaticMatrix<1, 4>({{bp_.y * n.x + bp_.x * n.y, n.x, n.y, 0.}}) * A_;
-
-        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
-        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
-    }
-    else
-    {
-        cells_.push_back(cell_);
-
-        auto xd = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / 2.;
-        auto xn = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / -length();
-
-        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
-        dirichletCoeffs_.push_back(1. / 2.);
-
-        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
-        neumannCoeffs_.push_back(1. / length());
-    }
+    update(ibObj, grid);
 }
 
 GhostCellStencil::GhostCellStencil(const Cell &cell,
@@ -70,54 +20,59 @@ GhostCellStencil::GhostCellStencil(const Cell &cell,
     bp_ = bp;
     ip_ = 2 * bp - cell.centroid();
     nw_ = (bp_ - ip_).unitVec();
-    cells_ = grid.findNearestNode(ip_).cells();
 
-    if (cells_.size() != 4)
-        throw Exception("GhostCellStencil", "GhostCellStencil", "number of image point cells must be 4.");
+    setDonorCells(grid.findNearestNode(ip_, &cell));
+    A_ = inverse(donorMatrix());
+    computeCoeffs(cl.unitVec());
+}
+
+void GhostCellStencil::update(const GhostCellImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid)
+{
+    if (locate(ibObj, grid))
+        A_ = inverse(donorMatrix());
 
+    computeCoeffs(nw_);
+}
+
+bool GhostCellStencil::locate(const GhostCellImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid)
+{
+    bp_ = ibObj.nearestIntersect(cell_.get().centroid());
+    ip_ = 2. * bp_ - cell_.get().centroid();
+    nw_ = ibObj.nearestEdgeNormal(bp_).unitVec();
+
+    //- The interpolation matrix only depends on the donor cells
+    const Node &node = grid.findNearestNode(ip_, &cell_.get());
+
+    if (cells_.empty() || node.id() != nodeId_)
+    {
+        setDonorCells(node);
+        return true;
+    }
+
+    cells_.erase(cells_.begin() + 4, cells_.end()); //- Drop the ghost cell
+    return false;
+}
+
+StaticMatrix<4, 4> GhostCellStencil::donorMatrix() const
+{
     Point2D x1 = cells_[0].get().centroid();
     Point2D x2 = cells_[1].get().centroid();
     Point2D x3 = cells_[2].get().centroid();
     Point2D x4 = cells_[3].get().centroid();
 
-    bool ghostCellInStencil = false;
-    for (const Cell &cell: cells_)
-        if (cell_.get().id() == cell.id())
-        {
-            ghostCellInStencil = true;
-            break;
-        }
-
-    A_ = inverse<4, 4>(
+    return StaticMatrix<4, 4>(
             {
                     x1.x * x1.y, x1.x, x1.y, 1.,
                     x2.x * x2.y, x2.x, x2.y, 1.,
                     x3.x * x3.y, x3.x, x3.y, 1.,
                     x4.x * x4.y, x4.x, x4.y, 1.,
             });
+}
 
-    if (ghostCellInStencil)
-    {
-        Vector2D n = cl.unitVec();
-        auto xd = StaticMatrix<1, 4>({bp_.x * bp_.y, bp_.x, bp_.y, 1.}) * A_;
-        auto xn = StaticMatrix<1, 4>({{bp_.y * n.x + bp_.x * n.y, n.x, n.y, 0.}}) * A_;
-
-        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
-        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
-    }
-    else
-    {
-        cells_.push_back(cell_);
-
-        auto xd = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / 2.;
-        auto xn = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / -length();
-
-        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
-        dirichletCoeffs_.push_back(1. / 2.);
-
-        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
-        neumannCoeffs_.push_back(1. / length());
-    }
+void GhostCellStencil::setCoeffs(const StaticMatrix<4, 4> &A)
+{
+    A_ = A;
+    computeCoeffs(nw_);
 }
 
 Scalar GhostCellStencil::ipValue(const ScalarFiniteVolumeField &field) const
@@ -151,7 +106,7 @@ Vector2D GhostCellStencil::ipValue(const VectorFiniteVolumeField &field) const
 
 Scalar GhostCellStencil::bpValue(const ScalarFiniteVolumeField &field) const
 {
-    auto cells = field.grid().findNearestNode(bp_).cells();
+    auto cells = field.grid().findNearestNode(bp_, &cell_.get()).cells();
 
     Point2D x1 = cells[0].get().centroid();
     Point2D x2 = cells[1].get().centroid();
@@ -178,7 +133,7 @@ Scalar GhostCellStencil::bpValue(const ScalarFiniteVolumeField &field) const
 
 Vector2D GhostCellStencil::bpValue(const VectorFiniteVolumeField &field) const
 {
-    auto cells = field.grid().findNearestNode(bp_).cells();
+    auto cells = field.grid().findNearestNode(bp_, &cell_.get()).cells();
 
     Point2D x1 = cells[0].get().centroid();
     Point2D x2 = cells[1].get().centroid();
@@ -221,7 +176,7 @@ Vector2D GhostCellStencil::ipGrad(const ScalarFiniteVolumeField &field) const
 
 Vector2D GhostCellStencil::bpGrad(const ScalarFiniteVolumeField &field) const
 {
-    auto cells = field.grid().findNearestNode(bp_).cells();
+    auto cells = field.grid().findNearestNode(bp_, &cell_.get()).cells();
 
     Point2D x1 = cells[0].get().centroid();
     Point2D x2 = cells[1].get().centroid();
@@ -251,7 +206,7 @@ Vector2D GhostCellStencil::bpGrad(const ScalarFiniteVolumeField &field) const
 
 Tensor2D GhostCellStencil::bpGrad(const VectorFiniteVolumeField &field) const
 {
-    auto cells = field.grid().findNearestNode(bp_).cells();
+    auto cells = field.grid().findNearestNode(bp_, &cell_.get()).cells();
 
     Point2D x1 = cells[0].get().centroid();
     Point2D x2 = cells[1].get().centroid();
@@ -277,4 +232,51 @@ Tensor2D GhostCellStencil::bpGrad(const VectorFiniteVolumeField &field) const
     auto x = StaticMatrix<2, 4>({bp_.y, 1., 0., 0., bp_.x, 0., 1., 0.}) * A * b;
 
     return Tensor2D(x(0, 0), x(1, 0), x(1, 0), x(1, 1));
-}
\ No newline at end of file
+}
+
+//- Protected methods
+
+void GhostCellStencil::setDonorCells(const Node &node)
+{
+    cells_ = node.cells();
+    nodeId_ = node.id();
+
+    if (cells_.size() != 4)
+        throw Exception("GhostCellStencil", "setDonorCells", "number of image point cells must be 4.");
+}
+
+void GhostCellStencil::computeCoeffs(const Vector2D &n)
+{
+    dirichletCoeffs_.clear();
+    neumannCoeffs_.clear();
+
+    bool ghostCellInStencil = false;
+    for (const Cell &cell: cells_)
+        if (cell_.get().id() == cell.id())
+        {
+            ghostCellInStencil = true;
+            break;
+        }
+
+    if (ghostCellInStencil)
+    {
+        auto xd = StaticMatrix<1, 4>({bp_.x * bp_.y, bp_.x, bp_.y, 1.}) * A_;
+        auto xn = StaticMatrix<1, 4>({{bp_.y * n.x + bp_.x * n.y, n.x, n.y, 0.}}) * A_;
+
+        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
+        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
+    }
+    else
+    {
+        cells_.push_back(cell_);
+
+        auto xd = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / 2.;
+        auto xn = StaticMatrix<1, 4>({ip_.x * ip_.y, ip_.x, ip_.y, 1.}) * A_ / -length();
+
+        dirichletCoeffs_.insert(dirichletCoeffs_.end(), xd.data(), xd.data() + 4);
+        dirichletCoeffs_.push_back(1. / 2.);
+
+        neumannCoeffs_.insert(neumannCoeffs_.end(), xn.data(), xn.data() + 4);
+        neumannCoeffs_.push_back(1. / length());
+    }
+}
@@ -23,6 +23,19 @@ public:
                      const Vector2D& cl,
                      const FiniteVolumeGrid2D &grid);
 
+    //- Update for the current position of the object, the interpolation matrix is reused if the donor cells are unchanged
+    void update(const GhostCellImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid);
+
+    //- Steps of update for stencils whose interpolation matrices are inverted in a batch. locate returns true if the
+    //- donor cells changed, in which case the inverse of donorMatrix() must be passed to setCoeffs
+    bool locate(const GhostCellImmersedBoundaryObject &ibObj, const FiniteVolumeGrid2D &grid);
+
+    StaticMatrix<4, 4> donorMatrix() const;
+
+    void setCoeffs(const StaticMatrix<4, 4> &A);
+
+    void setCoeffs()
+    { computeCoeffs(nw_); }
 
     const Point2D &boundaryPoint() const
     { return bp_; }
@@ -59,8 +72,14 @@ public:
 
 protected:
 
+    //- Donor cells of the image point are the cells of its nearest node
+    void setDonorCells(const Node &node);
+
+    void computeCoeffs(const Vector2D &n);
+
     StaticMatrix<4, 4> A_;
     Point2D ip_, bp_, nw_;
+    Label nodeId_;
 };
 
 #endif
@@ -2,6 +2,7 @@
 
 #include "HighOrderImmersedBoundaryObject.h"
 #include "HighOrderStencil.h"
+#include "BatchedMatrix.h"
 
 HighOrderImmersedBoundaryObject::HighOrderImmersedBoundaryObject(const std::string &name,
                                                                  Label id,
@@ -32,14 +33,12 @@ void HighOrderImmersedBoundaryObject::updateCells()
 
     //constructDirichletCoeffs();
     //constructNeumannCoeffs();
+
+    bcCoeffsValid_ = false;
 }
 
 Equation<Scalar> HighOrderImmersedBoundaryObject::bcs(ScalarFiniteVolumeField &phi) const
 {
-    typedef Eigen::Triplet<Scalar> Triplet;
-    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
-    typedef Eigen::SparseLU<SparseMatrix> Solver;
-
     Equation<Scalar> eqn(phi);
 
     for (const Cell &cell: solidCells_)
@@ -47,119 +46,14 @@ Equation<Scalar> HighOrderImmersedBoundaryObject::bcs(ScalarFiniteVolumeField &p
         eqn.add(cell, cell, 1.);
     }
 
-    //- Local ids of ibCells
-    std::unordered_map<int, int> ids;
-    ids.reserve(ibCells_.size());
-    int id = 0;
-    for (const Cell &cell: ibCells_)
-        ids[cell.id()] = id++;
-
-    int M = 0;
-    std::vector<Triplet> triplets;
-    std::vector<Ref<const Cell>> cells;
-
-    //- Cell eqns
-    for (const Cell &cell: ibCells_)
-    {
-        for (const CellLink &nb: cell.cellLinks())
-            if (!solidCells_.isInGroup(nb.cell()))
-            {
-                Point2D x = nb.cell().centroid();
-                int j = ids[cell.id()] * 6;
-
-                triplets.push_back(Triplet(M, j++, x.x * x.x));
-                triplets.push_back(Triplet(M, j++, x.y * x.y));
-                triplets.push_back(Triplet(M, j++, x.x * x.y));
-                triplets.push_back(Triplet(M, j++, x.x));
-                triplets.push_back(Triplet(M, j++, x.y));
-                triplets.push_back(Triplet(M, j++, 1.));
-                cells.push_back(std::cref(nb.cell()));
-                M++;
-            }
-    }
-
-    //- Compatibility eqns
-    for (const Cell &cell: ibCells_)
-    {
-        for (const CellLink &nb: cell.cellLinks())
-        {
-            if (ibCells_.isInGroup(nb.cell()))
-            {
-                Point2D x = nearestIntersect(nb.cell().centroid());
-                int j = ids[cell.id()] * 6;
-                triplets.push_back(Triplet(M, j++, x.x * x.x));
-                triplets.push_back(Triplet(M, j++, x.y * x.y));
-                triplets.push_back(Triplet(M, j++, x.x * x.y));
-                triplets.push_back(Triplet(M, j++, x.x));
-                triplets.push_back(Triplet(M, j++, x.y));
-                triplets.push_back(Triplet(M, j++, 1.));
-
-                j = ids[nb.cell().id()] * 6;
-                triplets.push_back(Triplet(M, j++, -x.x * x.x));
-                triplets.push_back(Triplet(M, j++, -x.y * x.y));
-                triplets.push_back(Triplet(M, j++, -x.x * x.y));
-                triplets.push_back(Triplet(M, j++, -x.x));
-                triplets.push_back(Triplet(M, j++, -x.y));
-                triplets.push_back(Triplet(M, j++, -1.));
-                M++;
-            }
-        }
-    }
-
-    //- Boundary eqns
-    for (const Cell &cell: ibCells_)
-    {
-        Point2D bp = nearestIntersect(cell.centroid());
-        Vector2D bn = nearestEdgeNormal(bp);
-
-        int j = ids[cell.id()] * 6;
-//        triplets.push_back(Triplet(M, j++, bp.x * bp.x));
-//        triplets.push_back(Triplet(M, j++, bp.y * bp.y));
-//        triplets.push_back(Triplet(M, j++, bp.x * bp.y));
-//        triplets.push_back(Triplet(M, j++, bp.x));
-//        triplets.push_back(Triplet(M, j++, bp.y));
-//        triplets.push_back(Triplet(M, j++, 1.));
-
-        triplets.push_back(Triplet(M, j++, 2. * bp.x * bn.x));
-        triplets.push_back(Triplet(M, j++, 2. * bp.y * bn.y));
-        triplets.push_back(Triplet(M, j++, bp.x * bn.y + bp.y * bn.x));
-        triplets.push_back(Triplet(M, j++, bn.x));
-        triplets.push_back(Triplet(M, j++, bn.y));
-        triplets.push_back(Triplet(M, j++, 0.));
-        M++;
-    }
-
-    //- Assemble matrix
-    SparseMatrix A(M, 6 * ibCells_.size());
-    A.setFromTriplets(triplets.begin(), triplets.end());
+    if (!bcCoeffsValid_ || bcCoeffs_.size() != ibCells_.size())
+        constructBcCoeffs();
 
-    triplets.clear();
+    Label i = 0;
     for (const Cell &cell: ibCells_)
     {
-        int j = ids[cell.id()];
-        int i = 6 * j;
-        Point2D x = cell.centroid();
-
-        triplets.push_back(Triplet(i++, j, x.x * x.x));
-        triplets.push_back(Triplet(i++, j, x.y * x.y));
-        triplets.push_back(Triplet(i++, j, x.x * x.y));
-        triplets.push_back(Triplet(i++, j, x.x));
-        triplets.push_back(Triplet(i++, j, x.y));
-        triplets.push_back(Triplet(i++, j, 1.));
-    }
-
-    //- X Matrix
-    SparseMatrix X(6 * ibCells_.size(), ibCells_.size());
-    X.setFromTriplets(triplets.begin(), triplets.end());
-    Solver solver;
-    SparseMatrix P = A.transpose() * A;
-    solver.compute(P);
-    X = (solver.solve(X)).transpose() * A.transpose();
-
-    for (const Cell &cell: ibCells_)
-    {
-        for (int j = 0; j < cells.size(); ++j)
-            eqn.add(cell, cells[j], X.coeff(ids[cell.id()], j));
+        for (const auto &coeff: bcCoeffs_[i++])
+            eqn.add(cell, bcCells_[coeff.first], coeff.second);
 
         eqn.add(cell, cell, -1.);
     }
@@ -400,6 +294,135 @@ void HighOrderImmersedBoundaryObject::computeForce(Scalar rho, Scalar mu,
 
 //- private
 
+void HighOrderImmersedBoundaryObject::constructBcCoeffs() const
+{
+    typedef Eigen::Triplet<Scalar> Triplet;
+    typedef Eigen::SparseMatrix<Scalar> SparseMatrix;
+    typedef Eigen::SparseLU<SparseMatrix> Solver;
+
+    //- Local ids of ibCells
+    std::unordered_map<int, int> ids;
+    ids.reserve(ibCells_.size());
+    int id = 0;
+    for (const Cell &cell: ibCells_)
+        ids[cell.id()] = id++;
+
+    int M = 0;
+    std::vector<Triplet> triplets;
+    std::vector<Ref<const Cell>> &cells = bcCells_;
+    cells.clear();
+
+    //- Cell eqns
+    for (const Cell &cell: ibCells_)
+    {
+        for (const CellLink &nb: cell.cellLinks())
+            if (!solidCells_.isInGroup(nb.cell()))
+            {
+                Point2D x = nb.cell().centroid();
+                int j = ids[cell.id()] * 6;
+
+                triplets.push_back(Triplet(M, j++, x.x * x.x));
+                triplets.push_back(Triplet(M, j++, x.y * x.y));
+                triplets.push_back(Triplet(M, j++, x.x * x.y));
+                triplets.push_back(Triplet(M, j++, x.x));
+                triplets.push_back(Triplet(M, j++, x.y));
+                triplets.push_back(Triplet(M, j++, 1.));
+                cells.push_back(std::cref(nb.cell()));
+                M++;
+            }
+    }
+
+    //- Compatibility eqns
+    for (const Cell &cell: ibCells_)
+    {
+        for (const CellLink &nb: cell.cellLinks())
+        {
+            if (ibCells_.isInGroup(nb.cell()))
+            {
+                Point2D x = nearestIntersect(nb.cell().centroid());
+                int j = ids[cell.id()] * 6;
+                triplets.push_back(Triplet(M, j++, x.x * x.x));
+                triplets.push_back(Triplet(M, j++, x.y * x.y));
+                triplets.push_back(Triplet(M, j++, x.x * x.y));
+                triplets.push_back(Triplet(M, j++, x.x));
+                triplets.push_back(Triplet(M, j++, x.y));
+                triplets.push_back(Triplet(M, j++, 1.));
+
+                j = ids[nb.cell().id()] * 6;
+                triplets.push_back(Triplet(M, j++, -x.x * x.x));
+                triplets.push_back(Triplet(M, j++, -x.y * x.y));
+                triplets.push_back(Triplet(M, j++, -x.x * x.y));
+                triplets.push_back(Triplet(M, j++, -x.x));
+                triplets.push_back(Triplet(M, j++, -x.y));
+                triplets.push_back(Triplet(M, j++, -1.));
+                M++;
+            }
+        }
+    }
+
+    //- Boundary eqns
+    for (const Cell &cell: ibCells_)
+    {
+        Point2D bp = nearestIntersect(cell.centroid());
+        Vector2D bn = nearestEdgeNormal(bp);
+
+        int j = ids[cell.id()] * 6;
+//        triplets.push_back(Triplet(M, j++, bp.x * bp.x));
+//        triplets.push_back(Triplet(M, j++, bp.y * bp.y));
+//        triplets.push_back(Triplet(M, j++, bp.x * bp.y));
+//        triplets.push_back(Triplet(M, j++, bp.x));
+//        triplets.push_back(Triplet(M, j++, bp.y));
+//        triplets.push_back(Triplet(M, j++, 1.));
+
+        triplets.push_back(Triplet(M, j++, 2. * bp.x * bn.x));
+        triplets.push_back(Triplet(M, j++, 2. * bp.y * bn.y));
+        triplets.push_back(Triplet(M, j++, bp.x * bn.y + bp.y * bn.x));
+        triplets.push_back(Triplet(M, j++, bn.x));
+        triplets.push_back(Triplet(M, j++, bn.y));
+        triplets.push_back(Triplet(M, j++, 0.));
+        M++;
+    }
+
+    //- Assemble matrix
+    SparseMatrix A(M, 6 * ibCells_.size());
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    triplets.clear();
+    for (const Cell &cell: ibCells_)
+    {
+        int j = ids[cell.id()];
+        int i = 6 * j;
+        Point2D x = cell.centroid();
+
+        triplets.push_back(Triplet(i++, j, x.x * x.x));
+        triplets.push_back(Triplet(i++, j, x.y * x.y));
+        triplets.push_back(Triplet(i++, j, x.x * x.y));
+        triplets.push_back(Triplet(i++, j, x.x));
+        triplets.push_back(Triplet(i++, j, x.y));
+        triplets.push_back(Triplet(i++, j, 1.));
+    }
+
+    //- X Matrix
+    SparseMatrix X(6 * ibCells_.size(), ibCells_.size());
+    X.setFromTriplets(triplets.begin(), triplets.end());
+    Solver solver;
+    SparseMatrix P = A.transpose() * A;
+    solver.compute(P);
+    Eigen::SparseMatrix<Scalar, Eigen::RowMajor> C = (solver.solve(X)).transpose() * A.transpose();
+
+    //- Rows are in the order of ibCells_. Only the cell eqns, the first bcCells_.size() columns, have a non-zero
+    //  rhs, the compatibility and boundary eqn columns multiply zero and are dropped
+    bcCoeffs_.assign(ibCells_.size(), std::vector<std::pair<Label, Scalar>>());
+
+    for (int i = 0; i < C.outerSize(); ++i)
+        for (Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it(C, i); it; ++it)
+            if (it.col() < bcCells_.size())
+                bcCoeffs_[i].push_back(std::make_pair(it.col(), it.value()));
+
+    bcCoeffsValid_ = true;
+}
+
+
 //void HighOrderImmersedBoundaryObject::constructDirichletCoeffsQuad()
 //{
 //    Ad_.clear();
@@ -469,19 +492,22 @@ void HighOrderImmersedBoundaryObject::constructDirichletCoeffs()
     bd_.clear();
     bps_.clear();
 
+    //- The least-squares systems of all ib cells are solved in one batch
+    BatchedMatrix<9, 6> A(ibCells_.size());
+    Label k = 0;
+
     for (const Cell &cell: ibCells_)
     {
-        StaticMatrix<9, 6> A;
         std::vector<Ref<const Cell>> stCells;
         std::vector<Point2D> bps;
 
-        auto addRow = [&A](int i, const Point2D &x) {
-            A(i, 0) = x.x * x.x;
-            A(i, 1) = x.y * x.y;
-            A(i, 2) = x.x * x.y;
-            A(i, 3) = x.x;
-            A(i, 4) = x.y;
-            A(i, 5) = 1.;
+        auto addRow = [&A, k](int i, const Point2D &x) {
+            A(k, i, 0) = x.x * x.x;
+            A(k, i, 1) = x.y * x.y;
+            A(k, i, 2) = x.x * x.y;
+            A(k, i, 3) = x.x;
+            A(k, i, 4) = x.y;
+            A(k, i, 5) = 1.;
         };
 
         int i = 0;
@@ -506,12 +532,20 @@ void HighOrderImmersedBoundaryObject::constructDirichletCoeffs()
         bps.push_back(nearestIntersect(cell.centroid()));
         addRow(i, bps.back());
 
+        stDCells_.push_back(stCells);
+        bps_.push_back(bps);
+        ++k;
+    }
+
+    BatchedMatrix<6, 9> Ad = pseudoInverse(A);
+    k = 0;
+
+    for (const Cell &cell: ibCells_)
+    {
         Point2D x = cell.centroid();
 
-        Ad_.push_back(pseudoInverse(A));
+        Ad_.push_back(Ad.get(k++));
         bd_.push_back(StaticMatrix<1, 6>({x.x * x.x, x.y * x.y, x.x * x.y, x.x, x.y, 1.}) * Ad_.back());
-        stDCells_.push_back(stCells);
-        bps_.push_back(bps);
     }
 }
 
@@ -596,28 +630,30 @@ void HighOrderImmersedBoundaryObject::constructNeumannCoeffs()
     stNCells_.clear();
     bns_.clear();
 
+    BatchedMatrix<9, 6> A(ibCells_.size());
+    Label k = 0;
+
     for (const Cell &cell: ibCells_)
     {
-        StaticMatrix<9, 6> A;
         std::vector<Ref<const Cell>> stCells;
         std::vector<Vector2D> bns;
 
-        auto addFixedRow = [&A](int i, const Point2D &x) {
-            A(i, 0) = x.x * x.x;
-            A(i, 1) = x.y * x.y;
-            A(i, 2) = x.x * x.y;
-            A(i, 3) = x.x;
-            A(i, 4) = x.y;
-            A(i, 5) = 1.;
+        auto addFixedRow = [&A, k](int i, const Point2D &x) {
+            A(k, i, 0) = x.x * x.x;
+            A(k, i, 1) = x.y * x.y;
+            A(k, i, 2) = x.x * x.y;
+            A(k, i, 3) = x.x;
+            A(k, i, 4) = x.y;
+            A(k, i, 5) = 1.;
         };
 
-        auto addDerivRow = [&A](int i, const Point2D &x, const Vector2D &n) {
-            A(i, 0) = 2. * x.x * n.x;
-            A(i, 1) = 2. * x.y * n.y;
-            A(i, 2) = x.y * n.x + x.x * n.y;
-            A(i, 3) = n.x;
-            A(i, 4) = n.y;
-            A(i, 5) = 0.;
+        auto addDerivRow = [&A, k](int i, const Point2D &x, const Vector2D &n) {
+            A(k, i, 0) = 2. * x.x * n.x;
+            A(k, i, 1) = 2. * x.y * n.y;
+            A(k, i, 2) = x.y * n.x + x.x * n.y;
+            A(k, i, 3) = n.x;
+            A(k, i, 4) = n.y;
+            A(k, i, 5) = 0.;
         };
 
         auto links = cell.cellLinks();
@@ -648,11 +684,19 @@ void HighOrderImmersedBoundaryObject::constructNeumannCoeffs()
         addDerivRow(i, bp, bn);
         bns.push_back(bn);
 
+        stNCells_.push_back(stCells);
+        bns_.push_back(bns);
+        ++k;
+    }
+
+    BatchedMatrix<6, 9> An = pseudoInverse(A);
+    k = 0;
+
+    for (const Cell &cell: ibCells_)
+    {
         Vector2D x = cell.centroid();
 
-        An_.push_back(pseudoInverse(A));
+        An_.push_back(An.get(k++));
         bn_.push_back(StaticMatrix<1, 6>({x.x * x.x, x.y * x.y, x.x * x.y, x.x, x.y, 1.}) * An_.back());
-        stNCells_.push_back(stCells);
-        bns_.push_back(bns);
     }
 }
\ No newline at end of file
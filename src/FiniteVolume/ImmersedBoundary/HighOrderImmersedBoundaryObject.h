@@ -43,6 +43,13 @@ private:
 
     void constructNeumannCoeffs();
 
+    //- The least-squares system of bcs only depends on the geometry, so its solution is kept until the cells change
+    void constructBcCoeffs() const;
+
+    mutable bool bcCoeffsValid_ = false;
+    mutable std::vector<Ref<const Cell>> bcCells_;
+    mutable std::vector<std::vector<std::pair<Label, Scalar>>> bcCoeffs_;
+
     std::vector<std::vector<Ref<const Cell>>> stDCells_, stNCells_;
     std::vector<std::vector<Point2D>> bps_;
     std::vector<std::vector<Vector2D>> bns_;
@@ -9,6 +9,7 @@
 #include "TranslatingMotion.h"
 #include "OscillatingMotion.h"
 #include "SolidBodyMotion.h"
+#include "BinaryStream.h"
 
 ImmersedBoundary::ImmersedBoundary(const Input &input, Solver &solver)
         :
@@ -266,6 +267,8 @@ ImmersedBoundary::ImmersedBoundary(const Input &input, Solver &solver)
     if (ibObjs_.empty())
         solver_.grid().comm().printf("No immersed boundaries present.\n");
 
+    updateSearchTree();
+
     for(const Node& node: grid().nodes())
     {
         if(!ibObj(node))
@@ -294,9 +297,44 @@ void ImmersedBoundary::initCellZones(CellZone &zone)
     }
 
     setCellStatus();
+    updateInactiveCells();
     solver_.grid().computeGlobalOrdering();
 }
 
+void ImmersedBoundary::clearCellZones()
+{
+    if (!zone_)
+        return;
+
+    //- Return all ib cells to the main zone, must be done before the grid cells are destroyed
+    for (auto &ibObj: ibObjs_)
+        ibObj->clear();
+
+    fluidNodes_.clear();
+
+    for (Label id: inactiveCells_)
+        solver_.grid().setCellActive(solver_.grid().cells()[id]);
+
+    inactiveCells_.clear();
+
+    if (collisionModel_)
+        collisionModel_->clearWallFaces();
+}
+
+void ImmersedBoundary::resetCellZones()
+{
+    if (!zone_)
+        return;
+
+    initCellZones(solver_.grid().cellZone(zone_->name()));
+
+    for (const Node &node: grid().nodes())
+    {
+        if (!ibObj(node))
+            fluidNodes_.add(node);
+    }
+}
+
 CellGroup ImmersedBoundary::ibCells() const
 {
     CellGroup ibCellGroup;
@@ -319,11 +357,7 @@ CellGroup ImmersedBoundary::solidCells() const
 
 std::shared_ptr<const ImmersedBoundaryObject> ImmersedBoundary::ibObj(const Point2D &pt) const
 {
-    for (const auto &ibObj: ibObjs_)
-        if (ibObj->isInIb(pt))
-            return ibObj;
-
-    return nullptr;
+    return ibObj(pt, pt);
 }
 
 std::shared_ptr<const ImmersedBoundaryObject> ImmersedBoundary::nearestIbObj(const Point2D& pt) const
@@ -337,8 +371,16 @@ std::pair<std::shared_ptr<const ImmersedBoundaryObject>, Point2D> ImmersedBounda
     Point2D minXc;
     Scalar minDistSqr = std::numeric_limits<Scalar>::infinity();
 
-    for(const auto& ibObj: *this)
+    //- Objects are visited in order of the distance to their bounding box, which bounds the distance to their boundary
+    for (auto it = searchTree_.qbegin(boost::geometry::index::nearest(pt, std::max(ibObjs_.size(), (Label) 1)));
+         it != searchTree_.qend(); ++it)
     {
+        Scalar boxDist = boost::geometry::distance(pt, it->first);
+
+        if (boxDist * boxDist > minDistSqr)
+            break;
+
+        const auto &ibObj = ibObjs_[it->second];
         Point2D xc = ibObj->nearestIntersect(pt);
         Scalar distSqr = (xc - pt).magSqr();
 
@@ -377,8 +419,11 @@ void ImmersedBoundary::update(Scalar timeStep)
     for (auto &ibObj: ibObjs_)
         ibObj->update(timeStep);
 
+    updateSearchTree();
     setCellStatus();
-    solver_.grid().computeGlobalOrdering();
+
+    if (updateInactiveCells())
+        solver_.grid().computeGlobalOrdering();
 
     for(const Node& node: grid().nodes())
     {
@@ -387,6 +432,31 @@ void ImmersedBoundary::update(Scalar timeStep)
     }
 }
 
+void ImmersedBoundary::writeCheckpoint(std::ostream &os) const
+{
+    writeBinary(os, (unsigned long) ibObjs_.size());
+
+    for (const auto &ibObj: ibObjs_)
+        ibObj->writeState(os);
+}
+
+void ImmersedBoundary::readCheckpoint(std::istream &is)
+{
+    unsigned long nIbObjs;
+    readBinary(is, nIbObjs);
+
+    if (nIbObjs != ibObjs_.size())
+        throw Exception("ImmersedBoundary", "readCheckpoint", "number of immersed boundary objects does not match the checkpoint.");
+
+    clearCellZones();
+
+    for (auto &ibObj: ibObjs_)
+        ibObj->readState(is);
+
+    updateSearchTree();
+    resetCellZones();
+}
+
 Equation<Vector2D> ImmersedBoundary::velocityBcs(VectorFiniteVolumeField &u) const
 {
     Equation<Vector2D> eqn(u);
@@ -425,13 +495,7 @@ void ImmersedBoundary::clearFreshCells()
 
 bool ImmersedBoundary::isIbCell(const Cell &cell) const
 {
-    for (const auto &ibObj: ibObjs_)
-    {
-        if (ibObj->isInIb(cell.centroid()))
-            return true;
-    }
-
-    return false;
+    return (bool) ibObj(cell);
 }
 
 void ImmersedBoundary::computeForce(Scalar rho,
@@ -440,17 +504,19 @@ void ImmersedBoundary::computeForce(Scalar rho,
                                     const ScalarFiniteVolumeField &p,
                                     const Vector2D &g)
 {
+    integrateForces([mu](const Face &) { return mu; }, u, p);
+
     for (auto ibObj: ibObjs_)
-        ibObj->computeForce(rho, mu, u, p, g);
+        if (ibObj->type() != ImmersedBoundaryObject::GHOST_CELL)
+            ibObj->computeForce(rho, mu, u, p, g);
 
     if (collisionModel_)
-        for (auto ibObjP: ibObjs_)
-        {
-            for (auto ibObjQ: ibObjs_)
-                ibObjP->addForce(collisionModel_->force(*ibObjP, *ibObjQ));
+    {
+        std::vector<Vector2D> fc = collisionModel_->forces(ibObjs_, grid());
 
-            ibObjP->addForce(collisionModel_->force(*ibObjP, ibObjP->grid()));
-        }
+        for (Label i = 0; i < ibObjs_.size(); ++i)
+            ibObjs_[i]->addForce(fc[i]);
+    }
 }
 
 void ImmersedBoundary::computeForce(const ScalarFiniteVolumeField &rho,
@@ -459,21 +525,67 @@ void ImmersedBoundary::computeForce(const ScalarFiniteVolumeField &rho,
                                     const ScalarFiniteVolumeField &p,
                                     const Vector2D &g)
 {
+    integrateForces([&mu](const Face &face) { return mu(face); }, u, p);
+
     for (auto ibObj: ibObjs_)
-        ibObj->computeForce(rho, mu, u, p, g);
+        if (ibObj->type() != ImmersedBoundaryObject::GHOST_CELL)
+            ibObj->computeForce(rho, mu, u, p, g);
 
     if (collisionModel_)
-        for (auto ibObjP: ibObjs_)
-        {
-            for (auto ibObjQ: ibObjs_)
-                ibObjP->addForce(collisionModel_->force(*ibObjP, *ibObjQ));
+    {
+        std::vector<Vector2D> fc = collisionModel_->forces(ibObjs_, grid());
 
-            ibObjP->addForce(collisionModel_->force(*ibObjP, ibObjP->grid()));
-        }
+        for (Label i = 0; i < ibObjs_.size(); ++i)
+            ibObjs_[i]->addForce(fc[i]);
+    }
 }
 
 //- Protected
 
+void ImmersedBoundary::integrateForces(const ImmersedBoundaryObject::Viscosity &mu,
+                                       const VectorFiniteVolumeField &u,
+                                       const ScalarFiniteVolumeField &p)
+{
+    //- Flatten the stencils of all ghost cell objects, so that the threads are balanced across objects
+    std::vector<std::shared_ptr<GhostCellImmersedBoundaryObject>> gcObjs;
+    std::vector<std::pair<Label, const GhostCellStencil *>> stencils;
+
+    for (const auto &ibObj: ibObjs_)
+        if (ibObj->type() == ImmersedBoundaryObject::GHOST_CELL)
+        {
+            gcObjs.push_back(std::static_pointer_cast<GhostCellImmersedBoundaryObject>(ibObj));
+
+            for (const GhostCellStencil &st: gcObjs.back()->stencils())
+                stencils.push_back(std::make_pair(gcObjs.size() - 1, &st));
+        }
+
+    if (gcObjs.empty())
+        return;
+
+    std::vector<Vector2D> forces(stencils.size());
+    std::vector<Scalar> torques(stencils.size());
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (Size i = 0; i < stencils.size(); ++i)
+        gcObjs[stencils[i].first]->stencilForce(*stencils[i].second, mu, u, p, forces[i], torques[i]);
+
+    //- Sum serially so that the results do not depend on the number of threads
+    std::vector<Scalar> sums(3 * gcObjs.size(), 0.);
+
+    for (Label i = 0; i < stencils.size(); ++i)
+    {
+        Label j = 3 * stencils[i].first;
+        sums[j] += forces[i].x;
+        sums[j + 1] += forces[i].y;
+        sums[j + 2] += torques[i];
+    }
+
+    sums = grid().comm().sum(sums);
+
+    for (Label i = 0; i < gcObjs.size(); ++i)
+        gcObjs[i]->setForce(Vector2D(sums[3 * i], sums[3 * i + 1]), sums[3 * i + 2]);
+}
+
 void ImmersedBoundary::setCellStatus()
 {
     cellStatus_.fill(0);
@@ -500,3 +612,41 @@ void ImmersedBoundary::setCellStatus()
             cellStatus_(cell) = DEAD_CELLS;
     }
 }
+
+bool ImmersedBoundary::updateInactiveCells()
+{
+    //- Only the cells changed by the last update of each object are moved
+    FiniteVolumeGrid2D &grid = solver_.grid();
+    bool changed = false;
+
+    for (const auto &ibObj: ibObjs_)
+    {
+        for (const Cell &cell: ibObj->reactivatedCells())
+            if (inactiveCells_.erase(cell.id()))
+            {
+                grid.setCellActive(cell);
+                changed = true;
+            }
+
+        for (const Cell &cell: ibObj->deactivatedCells())
+            if (inactiveCells_.insert(cell.id()).second)
+            {
+                grid.setCellInactive(cell);
+                changed = true;
+            }
+    }
+
+    return grid.comm().max((int) changed);
+}
+
+void ImmersedBoundary::updateSearchTree()
+{
+    std::vector<BoxValue> boxes;
+    boxes.reserve(ibObjs_.size());
+
+    for (Label i = 0; i < ibObjs_.size(); ++i)
+        boxes.push_back(std::make_pair(ibObjs_[i]->shape().boundingBox(), i));
+
+    //- Bulk loading gives a better tree than refitting, and is cheap for the number of objects considered
+    searchTree_ = decltype(searchTree_)(boxes.begin(), boxes.end());
+}
@@ -1,6 +1,8 @@
 #ifndef IMMERSED_BOUNDARY_H
 #define IMMERSED_BOUNDARY_H
 
+#include <boost/geometry/index/rtree.hpp>
+
 #include "ImmersedBoundaryObject.h"
 #include "CollisionModel.h"
 
@@ -27,6 +29,10 @@ public:
     //- Cell zones
     void initCellZones(CellZone &zone);
 
+    void clearCellZones();
+
+    void resetCellZones();
+
     const CellZone &zone() const
     { return *zone_; }
 
@@ -40,6 +46,13 @@ public:
     //- Immersed boundary object access
     std::shared_ptr<const ImmersedBoundaryObject> ibObj(const Point2D &pt) const;
 
+    //- Cells and nodes use the cached distances of the objects
+    std::shared_ptr<const ImmersedBoundaryObject> ibObj(const Cell &cell) const
+    { return ibObj(cell.centroid(), cell); }
+
+    std::shared_ptr<const ImmersedBoundaryObject> ibObj(const Node &node) const
+    { return ibObj(node, node); }
+
     std::shared_ptr<const ImmersedBoundaryObject> nearestIbObj(const Point2D& pt) const;
 
     std::pair<std::shared_ptr<const ImmersedBoundaryObject>, Point2D> nearestIntersect(const Point2D& pt) const;
@@ -60,6 +73,11 @@ public:
     //- Updates
     void update(Scalar timeStep);
 
+    //- Checkpointing, reading restores the objects and reclassifies the cells
+    void writeCheckpoint(std::ostream &os) const;
+
+    void readCheckpoint(std::istream &is);
+
     //- Boundary conditions
     template<class T>
     void copyBoundaryTypes(const FiniteVolumeField<T> &srcField, const FiniteVolumeField<T> &destField)
@@ -105,15 +123,39 @@ protected:
 
     void setCellStatus();
 
+    //- Remove the inactive cells of all objects from the linear systems. Returns true on all procs if the inactive
+    //- cells changed on any proc, in which case a new global ordering is required
+    bool updateInactiveCells();
+
+    //- Integrate the forces on all ghost cell objects in one threaded pass over their stencils, with a single
+    //- reduction for all objects
+    void integrateForces(const ImmersedBoundaryObject::Viscosity &mu,
+                         const VectorFiniteVolumeField &u,
+                         const ScalarFiniteVolumeField &p);
+
+    //- The first object containing an item located at pt
+    template<class T>
+    std::shared_ptr<const ImmersedBoundaryObject> ibObj(const Point2D &pt, const T &item) const;
+
+    //- Rebuild the search tree over the object bounding boxes, must be called whenever the objects move
+    void updateSearchTree();
+
     const CellZone *zone_ = nullptr;
     NodeGroup fluidNodes_;
+    std::unordered_set<Label> inactiveCells_;
 
     Solver &solver_;
     FiniteVolumeField<int> &cellStatus_;
     std::vector<std::shared_ptr<ImmersedBoundaryObject>> ibObjs_;
 
+    //- Bounding boxes of the objects, paired with their index in ibObjs_
+    typedef std::pair<boost::geometry::model::box<Point2D>, Label> BoxValue;
+    boost::geometry::index::rtree<BoxValue, boost::geometry::index::quadratic<8, 1>> searchTree_;
+
     //- Collision model
     std::shared_ptr<CollisionModel> collisionModel_;
 };
 
+#include "ImmersedBoundary.tpp"
+
 #endif
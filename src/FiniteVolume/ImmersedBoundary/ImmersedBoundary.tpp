@@ -0,0 +1,17 @@
+#include "ImmersedBoundary.h"
+
+template<class T>
+std::shared_ptr<const ImmersedBoundaryObject> ImmersedBoundary::ibObj(const Point2D &pt, const T &item) const
+{
+    std::vector<BoxValue> candidates;
+    searchTree_.query(boost::geometry::index::intersects(pt), std::back_inserter(candidates));
+
+    //- Where objects overlap the first in input order is returned
+    Label first = ibObjs_.size();
+
+    for (const BoxValue &candidate: candidates)
+        if (candidate.second < first && ibObjs_[candidate.second]->isInIb(item))
+            first = candidate.second;
+
+    return first < ibObjs_.size() ? ibObjs_[first] : nullptr;
+}
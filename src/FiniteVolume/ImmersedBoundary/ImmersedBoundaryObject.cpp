@@ -3,6 +3,7 @@
 #include "ImmersedBoundaryObject.h"
 #include "TranslatingMotion.h"
 #include "OscillatingMotion.h"
+#include "BinaryStream.h"
 
 ImmersedBoundaryObject::ImmersedBoundaryObject(const std::string &name,
                                                Label id,
@@ -16,8 +17,11 @@ ImmersedBoundaryObject::ImmersedBoundaryObject(const std::string &name,
     zoneRegistry_ = std::make_shared<CellZone::ZoneRegistry>();
     ibCells_ = CellZone("IbCells", zoneRegistry_);
     solidCells_ = CellZone("SolidCells", zoneRegistry_);
-    freshCells_ = CellZone("FreshCells", zoneRegistry_);
-    deadCells_ = CellZone("DeadCells", zoneRegistry_);
+
+    //- Fresh and dead cells are tracked separately, dead cells are also ib or solid cells
+    auto changedRegistry = std::make_shared<CellZone::ZoneRegistry>();
+    freshCells_ = CellZone("FreshCells", changedRegistry);
+    deadCells_ = CellZone("DeadCells", changedRegistry);
 
     force_ = Vector2D(0., 0.);
     torque_ = 0.;
@@ -26,6 +30,7 @@ ImmersedBoundaryObject::ImmersedBoundaryObject(const std::string &name,
 void ImmersedBoundaryObject::initCircle(const Point2D &center, Scalar radius)
 {
     shapePtr_ = std::make_shared<Circle>(center, radius);
+    distanceField_ = nullptr;
 }
 
 
@@ -35,6 +40,7 @@ void ImmersedBoundaryObject::initBox(const Point2D &center, Scalar width, Scalar
             Point2D(center.x - width / 2., center.y - height / 2.),
             Point2D(center.x + width / 2., center.y + height / 2.)
     );
+    distanceField_ = nullptr;
 }
 
 void ImmersedBoundaryObject::setMotion(std::shared_ptr<Motion> motion)
@@ -55,6 +61,12 @@ void ImmersedBoundaryObject::clear()
     solidCells_.clear();
     freshCells_.clear();
     deadCells_.clear();
+    inactiveCells_.clear();
+    deactivatedCells_.clear();
+    reactivatedCells_.clear();
+
+    if (distanceField_)
+        distanceField_->clearCache();
     //grid_.setCellsActive(fluid_->begin(), fluid_->end());
 }
 
@@ -82,8 +94,9 @@ Vector2D ImmersedBoundaryObject::nearestEdgeNormal(const Point2D &pt) const
     {
         case Shape2D::CIRCLE:
             return (shapePtr_->centroid() - pt).unitVec();
-        case Shape2D::BOX:
         case Shape2D::POLYGON:
+            return -distanceField()->query(pt).normal;
+        case Shape2D::BOX:
         {
             auto edge = shapePtr_->nearestEdge(pt);
             return dot(edge.norm(), shapePtr_->centroid() - edge.center()) > 0. ? edge.norm().unitVec()
@@ -231,10 +244,57 @@ void ImmersedBoundaryObject::update(Scalar timeStep)
     if (motion_)
     {
         motion_->update(timeStep);
+
+        if (distanceField_)
+            distanceField_->setFrame(position(), theta());
+
         updateCells();
     }
 }
 
+void ImmersedBoundaryObject::writeState(std::ostream &os) const
+{
+    writeBinary(os, name_);
+    writeBinary(os, position());
+    writeBinary(os, force_);
+    writeBinary(os, torque_);
+    writeBinary(os, (int) isMoving());
+
+    if (motion_)
+        motion_->writeState(os);
+}
+
+void ImmersedBoundaryObject::readState(std::istream &is)
+{
+    std::string name;
+    Point2D pos;
+    int isMoving;
+
+    readBinary(is, name);
+
+    if (name != name_)
+        throw Exception("ImmersedBoundaryObject", "readState", "expected immersed boundary object \"" + name_
+                                                               + "\" but found \"" + name + "\".");
+
+    readBinary(is, pos);
+    readBinary(is, force_);
+    readBinary(is, torque_);
+    readBinary(is, isMoving);
+
+    if (isMoving != (bool) motion_)
+        throw Exception("ImmersedBoundaryObject", "readState", "motion of immersed boundary object \"" + name_
+                                                               + "\" does not match the checkpoint.");
+
+    shapePtr_->move(pos);
+    distanceField_ = nullptr;
+
+    if (motion_)
+    {
+        motion_->readState(is);
+        shapePtr_->rotate(motion_->theta());
+    }
+}
+
 void ImmersedBoundaryObject::updateCells()
 {
     clear();
@@ -269,10 +329,7 @@ Equation<Vector2D> ImmersedBoundaryObject::velocityBcs(VectorFiniteVolumeField &
     Equation<Vector2D> eqn(u);
 
     for (const Cell &cell: solidCells_)
-    {
-        eqn.add(cell, cell, 1.);
-        eqn.addSource(cell, -velocity(cell.centroid()));
-    }
+        fixSolidCell(eqn, u, cell, velocity(cell.centroid()));
 
     return eqn;
 }
@@ -282,3 +339,14 @@ void ImmersedBoundaryObject::clearFreshCells()
     fluid_->add(freshCells_); //- Should also clear cells from cells_
     freshCells_.clear();
 }
+
+//- Protected methods
+
+const SignedDistanceField *ImmersedBoundaryObject::distanceField() const
+{
+    if (!distanceField_ && shapePtr_->type() == Shape2D::POLYGON)
+        distanceField_ = std::make_shared<SignedDistanceField>(static_cast<const Polygon &>(*shapePtr_),
+                                                               position(), theta());
+
+    return distanceField_.get();
+}
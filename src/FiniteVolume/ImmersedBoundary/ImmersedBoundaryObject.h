@@ -1,9 +1,13 @@
 #ifndef IMMERSED_BOUNDARY_OBJECT_H
 #define IMMERSED_BOUNDARY_OBJECT_H
 
+#include <functional>
+#include <unordered_set>
+
 #include "Shape2D.h"
 #include "Equation.h"
 #include "Motion.h"
+#include "SignedDistanceField.h"
 
 class ImmersedBoundaryObject
 {
@@ -12,6 +16,9 @@ public:
     typedef typename std::vector<std::shared_ptr<ImmersedBoundaryObject>>::iterator iterator;
     typedef typename std::vector<std::shared_ptr<ImmersedBoundaryObject>>::const_iterator const_iterator;
 
+    //- Viscosity at a face, so that constant and variable viscosity share the force integration
+    typedef std::function<Scalar(const Face &)> Viscosity;
+
     enum Type
     {
         GHOST_CELL, STEP, QUADRATIC, HIGH_ORDER
@@ -38,6 +45,7 @@ public:
     void initPolygon(const_iterator begin, const_iterator end)
     {
         shapePtr_ = std::make_shared<Polygon>(begin, end);
+        distanceField_ = nullptr;
     }
 
     Shape2D &shape()
@@ -47,7 +55,14 @@ public:
     { return *shapePtr_; }
 
     bool isInIb(const Point2D &pt) const
-    { return shapePtr_->isInside(pt); }
+    { return distanceField() ? distanceField()->isInside(pt) : shapePtr_->isInside(pt); }
+
+    //- Cells and nodes use the cached distances of polygons
+    bool isInIb(const Cell &cell) const
+    { return distanceField() ? distanceField()->isInside(cell) : shapePtr_->isInside(cell.centroid()); }
+
+    bool isInIb(const Node &node) const
+    { return distanceField() ? distanceField()->isInside(node) : shapePtr_->isInside(node); }
 
     template<class T>
     bool isInIb(const T &item) const
@@ -97,7 +112,7 @@ public:
     LineSegment2D intersectionLine(const Point2D &ptA, const Point2D &ptB) const;
 
     Point2D nearestIntersect(const Point2D &pt) const
-    { return shapePtr_->nearestIntersect(pt); }
+    { return distanceField() ? distanceField()->query(pt).xc : shapePtr_->nearestIntersect(pt); }
 
     Vector2D nearestEdgeNormal(const Point2D &pt) const;
 
@@ -132,6 +147,14 @@ public:
     const CellZone &deadCells() const
     { return deadCells_; }
 
+    //- Solid cells that no equation couples to, which can be removed from the linear systems. Only the changes
+    //- made by the last update of the cells are exposed
+    const std::vector<Ref<const Cell>> &deactivatedCells() const
+    { return deactivatedCells_; }
+
+    const std::vector<Ref<const Cell>> &reactivatedCells() const
+    { return reactivatedCells_; }
+
     //- Boundary info
     BoundaryType boundaryType(const std::string &name) const
     { return boundaryTypes_.find(name)->second; }
@@ -177,6 +200,12 @@ public:
         force_ += force;
     }
 
+    void setForce(const Vector2D &force, Scalar torque)
+    {
+        force_ = force;
+        torque_ = torque;
+    }
+
     Scalar mass() const
     { return rho * shapePtr_->area(); }
 
@@ -192,6 +221,12 @@ public:
     //- Update
     void update(Scalar timeStep);
 
+    //- Checkpointing of the position, forces and motion state. Shapes are restored relative to their input
+    //- configuration, and the cells must be updated afterwards
+    void writeState(std::ostream &os) const;
+
+    void readState(std::istream &is);
+
     virtual void updateCells();
 
     //- Boundary conditions
@@ -229,8 +264,29 @@ protected:
     CellZone cells_, ibCells_, solidCells_, freshCells_, deadCells_;
     CellZone *fluid_ = nullptr;
 
+    std::unordered_set<Label> inactiveCells_;
+    std::vector<Ref<const Cell>> deactivatedCells_, reactivatedCells_;
+
     std::shared_ptr<Shape2D> shapePtr_;
 
+    //- Fix the value of a solid cell by an identity row, or directly if it has been removed from the linear systems
+    template<typename T>
+    void fixSolidCell(Equation<T> &eqn, FiniteVolumeField<T> &field, const Cell &cell, const T &val) const
+    {
+        if (grid_.localActiveCells().isInGroup(cell))
+        {
+            eqn.add(cell, cell, 1.);
+            eqn.addSource(cell, -val);
+        }
+        else
+            field(cell) = val;
+    }
+
+    //- Body frame distance field of polygons, constructed on first use and moved with the object
+    const SignedDistanceField *distanceField() const;
+
+    mutable std::shared_ptr<SignedDistanceField> distanceField_;
+
     std::unordered_map<std::string, BoundaryType> boundaryTypes_;
     std::unordered_map<std::string, Scalar> boundaryRefScalars_;
     std::unordered_map<std::string, Vector2D> boundaryRefVectors_;
@@ -1,5 +1,6 @@
 #include "Motion.h"
 #include "ImmersedBoundaryObject.h"
+#include "BinaryStream.h"
 
 Motion::Motion(std::weak_ptr<ImmersedBoundaryObject> ibObj)
 {
@@ -11,4 +12,24 @@ Motion::Motion(std::weak_ptr<ImmersedBoundaryObject> ibObj)
     alpha_ = 0.;
     omega_ = 0.;
     theta_ = 0.;
-}
\ No newline at end of file
+}
+
+void Motion::writeState(std::ostream &os) const
+{
+    writeBinary(os, alpha_);
+    writeBinary(os, omega_);
+    writeBinary(os, theta_);
+    writeBinary(os, acc_);
+    writeBinary(os, vel_);
+    writeBinary(os, pos_);
+}
+
+void Motion::readState(std::istream &is)
+{
+    readBinary(is, alpha_);
+    readBinary(is, omega_);
+    readBinary(is, theta_);
+    readBinary(is, acc_);
+    readBinary(is, vel_);
+    readBinary(is, pos_);
+}
@@ -1,6 +1,8 @@
 #ifndef MOTION_H
 #define MOTION_H
 
+#include <iosfwd>
+
 #include "Point2D.h"
 
 class ImmersedBoundaryObject;
@@ -34,6 +36,11 @@ public:
     Scalar theta() const
     { return theta_; }
 
+    //- Checkpointing of the motion state
+    virtual void writeState(std::ostream &os) const;
+
+    virtual void readState(std::istream &is);
+
 protected:
 
     Scalar alpha_, omega_, theta_;
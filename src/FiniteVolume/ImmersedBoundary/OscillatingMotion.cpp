@@ -1,5 +1,6 @@
 #include "OscillatingMotion.h"
 #include "ImmersedBoundaryObject.h"
+#include "BinaryStream.h"
 
 OscillatingMotion::OscillatingMotion(std::weak_ptr<ImmersedBoundaryObject> ibObj,
                                      const Vector2D &freq,
@@ -26,4 +27,16 @@ void OscillatingMotion::update(Scalar timeStep)
     vel_ = Vector2D(amp_.x * omega.x * cos(omega.x * time_), amp_.y * omega.y * cos(omega.y * time_));
     acc_ = Vector2D(-amp_.x * pow(omega.x, 2) * sin(omega.x * time_), -amp_.y * pow(omega.y, 2) * sin(omega.y * time_));
     ibObj_.lock()->shape().move(x);
-}
\ No newline at end of file
+}
+
+void OscillatingMotion::writeState(std::ostream &os) const
+{
+    Motion::writeState(os);
+    writeBinary(os, time_);
+}
+
+void OscillatingMotion::readState(std::istream &is)
+{
+    Motion::readState(is);
+    readBinary(is, time_);
+}
@@ -16,6 +16,10 @@ public:
 
     void update(Scalar timeStep);
 
+    void writeState(std::ostream &os) const;
+
+    void readState(std::istream &is);
+
 private:
     Vector2D freq_, amp_, phase_;
     Scalar time_;
@@ -0,0 +1,154 @@
+#include <limits>
+#include <algorithm>
+
+#include "SignedDistanceField.h"
+
+SignedDistanceField::SignedDistanceField(const Polygon &polygon, const Point2D &pos, Scalar theta)
+{
+    setFrame(pos, theta);
+
+    for (const Point2D &vtx: polygon.vertices())
+        vertices_.push_back(toBody(vtx));
+
+    //- Rings are closed
+    if (vertices_.size() > 1 && vertices_.front() == vertices_.back())
+        vertices_.pop_back();
+
+    Scalar area = 0.;
+
+    for (Label i = 0; i < vertices_.size(); ++i)
+        area += cross(vertices_[i], vertices_[(i + 1) % vertices_.size()]);
+
+    if (area < 0.)
+        std::reverse(vertices_.begin(), vertices_.end());
+
+    std::vector<EdgeValue> edges;
+
+    for (Label i = 0; i < vertices_.size(); ++i)
+    {
+        const Point2D &ptA = vertices_[i], &ptB = vertices_[(i + 1) % vertices_.size()];
+
+        normals_.push_back((ptB - ptA).normalVec().unitVec());
+        edges.push_back(std::make_pair(
+                boost::geometry::model::box<Point2D>(Point2D(std::min(ptA.x, ptB.x), std::min(ptA.y, ptB.y)),
+                                                     Point2D(std::max(ptA.x, ptB.x), std::max(ptA.y, ptB.y))), i));
+    }
+
+    edgeTree_ = decltype(edgeTree_)(edges.begin(), edges.end());
+}
+
+void SignedDistanceField::setFrame(const Point2D &pos, Scalar theta)
+{
+    pos_ = pos;
+    cosTheta_ = std::cos(theta);
+    sinTheta_ = std::sin(theta);
+}
+
+SignedDistanceField::Result SignedDistanceField::query(const Point2D &pt) const
+{
+    Result result = bodyQuery(toBody(pt), std::numeric_limits<Scalar>::infinity());
+    result.xc = toWorld(result.xc);
+    result.normal = Vector2D(cosTheta_ * result.normal.x - sinTheta_ * result.normal.y,
+                             sinTheta_ * result.normal.x + cosTheta_ * result.normal.y);
+
+    return result;
+}
+
+void SignedDistanceField::clearCache()
+{
+    cellCache_.clear();
+    nodeCache_.clear();
+}
+
+//- Private methods
+
+Point2D SignedDistanceField::toBody(const Point2D &pt) const
+{
+    Vector2D r = pt - pos_;
+    return Point2D(cosTheta_ * r.x + sinTheta_ * r.y, cosTheta_ * r.y - sinTheta_ * r.x);
+}
+
+Point2D SignedDistanceField::toWorld(const Point2D &pt) const
+{
+    return Point2D(cosTheta_ * pt.x - sinTheta_ * pt.y, sinTheta_ * pt.x + cosTheta_ * pt.y) + pos_;
+}
+
+SignedDistanceField::Result SignedDistanceField::bodyQuery(const Point2D &pt, Scalar radius) const
+{
+    namespace bgi = boost::geometry::index;
+
+    Scalar minDistSqr = std::numeric_limits<Scalar>::infinity(), minT = 0.;
+    Label minEdge = 0;
+    Point2D minXc;
+
+    auto test = [&](Label i) {
+        const Point2D &ptA = vertices_[i];
+        Vector2D t = vertices_[(i + 1) % vertices_.size()] - ptA;
+
+        if (t.magSqr() == 0.)
+            return;
+
+        Scalar s = std::max(0., std::min(1., dot(pt - ptA, t) / t.magSqr()));
+        Point2D xc = ptA + s * t;
+        Scalar distSqr = (pt - xc).magSqr();
+
+        if (distSqr < minDistSqr)
+        {
+            minDistSqr = distSqr;
+            minEdge = i;
+            minT = s;
+            minXc = xc;
+        }
+    };
+
+    if (radius < std::numeric_limits<Scalar>::infinity())
+    {
+        boost::geometry::model::box<Point2D> box(Point2D(pt.x - radius, pt.y - radius),
+                                                 Point2D(pt.x + radius, pt.y + radius));
+
+        for (auto it = edgeTree_.qbegin(bgi::intersects(box)); it != edgeTree_.qend(); ++it)
+            test(it->second);
+    }
+
+    //- Edges are visited in order of the distance to their bounding box, which bounds the distance to the edge
+    if (minDistSqr == std::numeric_limits<Scalar>::infinity())
+        for (auto it = edgeTree_.qbegin(bgi::nearest(pt, vertices_.size())); it != edgeTree_.qend(); ++it)
+        {
+            Scalar boxDist = boost::geometry::distance(pt, it->first);
+
+            if (boxDist * boxDist > minDistSqr)
+                break;
+
+            test(it->second);
+        }
+
+    //- The sign at a vertex is given by the sum of the normals of its edges
+    Vector2D n = normals_[minEdge];
+
+    if (minT == 0.)
+        n += normals_[(minEdge + vertices_.size() - 1) % vertices_.size()];
+    else if (minT == 1.)
+        n += normals_[(minEdge + 1) % vertices_.size()];
+
+    Scalar distance = std::sqrt(minDistSqr);
+
+    return Result{dot(pt - minXc, n) < 0. ? -distance : distance, minXc, normals_[minEdge]};
+}
+
+bool SignedDistanceField::isInside(Label id, const Point2D &pt, std::vector<Entry> &cache) const
+{
+    if (id >= cache.size())
+        cache.resize(id + 1, Entry{Point2D(0., 0.), 0., false});
+
+    Entry &entry = cache[id];
+    Point2D bodyPt = toBody(pt);
+    Scalar moved = entry.valid ? (bodyPt - entry.pt).mag() : std::numeric_limits<Scalar>::infinity();
+
+    if (moved < std::abs(entry.distance))
+        return entry.distance < 0.;
+
+    //- The nearest edge is within the previous distance plus the distance moved
+    entry = Entry{bodyPt, bodyQuery(bodyPt, std::abs(entry.distance) + moved).distance, true};
+
+    return entry.distance < 0.;
+}
@@ -0,0 +1,75 @@
+#ifndef SIGNED_DISTANCE_FIELD_H
+#define SIGNED_DISTANCE_FIELD_H
+
+#include <boost/geometry/index/rtree.hpp>
+
+#include "Polygon.h"
+#include "Cell.h"
+#include "Node.h"
+
+//- Signed distance to a rigidly moving polygon, negative inside. The polygon is stored in its body frame with its edges
+//- indexed by an rtree, so that queries do not visit every vertex. The distances of cells and nodes are cached with
+//- the body frame point they were computed at. Since the distance is 1-Lipschitz, a cached sign remains valid until
+//- the point has moved relative to the body by more than its distance, and otherwise only nearby edges are searched
+class SignedDistanceField
+{
+public:
+
+    struct Result
+    {
+        Scalar distance;
+        Point2D xc; //- Nearest boundary point
+        Vector2D normal; //- Outward unit normal of the nearest edge
+    };
+
+    //- The body frame is defined by the configuration of the polygon when constructed
+    SignedDistanceField(const Polygon &polygon, const Point2D &pos, Scalar theta);
+
+    //- Set the current configuration, the polygon is the body frame polygon rotated by theta and moved to pos
+    void setFrame(const Point2D &pos, Scalar theta);
+
+    Result query(const Point2D &pt) const;
+
+    bool isInside(const Point2D &pt) const
+    { return query(pt).distance < 0.; }
+
+    bool isInside(const Cell &cell) const
+    { return isInside(cell.id(), cell.centroid(), cellCache_); }
+
+    bool isInside(const Node &node) const
+    { return isInside(node.id(), node, nodeCache_); }
+
+    //- Must be called when the cells or nodes of the grid change
+    void clearCache();
+
+private:
+
+    struct Entry
+    {
+        Point2D pt;
+        Scalar distance;
+        bool valid;
+    };
+
+    Point2D toBody(const Point2D &pt) const;
+
+    Point2D toWorld(const Point2D &pt) const;
+
+    //- Query in the body frame, only edges within radius of the point are searched when it is finite
+    Result bodyQuery(const Point2D &pt, Scalar radius) const;
+
+    bool isInside(Label id, const Point2D &pt, std::vector<Entry> &cache) const;
+
+    std::vector<Point2D> vertices_; //- Body frame, counter-clockwise
+    std::vector<Vector2D> normals_;
+
+    typedef std::pair<boost::geometry::model::box<Point2D>, Label> EdgeValue;
+    boost::geometry::index::rtree<EdgeValue, boost::geometry::index::quadratic<8, 1>> edgeTree_;
+
+    Point2D pos_;
+    Scalar cosTheta_, sinTheta_;
+
+    mutable std::vector<Entry> cellCache_, nodeCache_;
+};
+
+#endif
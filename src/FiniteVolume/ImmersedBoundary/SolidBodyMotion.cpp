@@ -1,5 +1,6 @@
 #include "SolidBodyMotion.h"
 #include "ImmersedBoundaryObject.h"
+#include "BinaryStream.h"
 
 SolidBodyMotion::SolidBodyMotion(std::weak_ptr<ImmersedBoundaryObject> ibObj, const Vector2D& v0)
         :
@@ -40,4 +41,18 @@ void SolidBodyMotion::update(Scalar timeStep)
 
     ibObj->shape().move(pos_);
     ibObj->shape().rotate(theta_ - theta0);
-}
\ No newline at end of file
+}
+
+void SolidBodyMotion::writeState(std::ostream &os) const
+{
+    Motion::writeState(os);
+    writeBinary(os, force_);
+    writeBinary(os, torque_);
+}
+
+void SolidBodyMotion::readState(std::istream &is)
+{
+    Motion::readState(is);
+    readBinary(is, force_);
+    readBinary(is, torque_);
+}
@@ -13,6 +13,10 @@ public:
 
     void update(Scalar timeStep);
 
+    void writeState(std::ostream &os) const;
+
+    void readState(std::istream &is);
+
 private:
 
     Vector2D force_;
@@ -86,6 +86,9 @@ public:
     //- Nodes
     const std::vector<Ref<const Node> > nodes() const;
 
+    const std::vector<Label> &nodeIds() const
+    { return nodeIds_; }
+
     const Polygon &shape() const
     { return cellShape_; }
 
@@ -1,4 +1,5 @@
 #include "CgnsUnstructuredGrid.h"
+#include "MeshCache.h"
 #include "Communicator.h"
 #include "Exception.h"
 
@@ -15,6 +16,30 @@ CgnsUnstructuredGrid::CgnsUnstructuredGrid(const Input &input)
 {
     const std::string filename = input.caseInput().get<std::string>("Grid.filename");
     const Scalar convertToMeters = input.caseInput().get<Scalar>("Grid.convertToMeters", 1.);
+    const Point2D origin = input.caseInput().get<std::string>("Grid.origin", "(0,0)");
+
+    //- A binary cache of the grid and its connectivity is used if one exists for this mesh, and is otherwise
+    //- generated after the mesh is read. It is invalidated by any change to the mesh file or its transformation
+    const bool useCache = input.caseInput().get<bool>("Grid.cache", true);
+    const std::string cacheFilename = input.caseInput().get<std::string>("Grid.cacheFilename", filename + ".cache");
+    unsigned long sourceHash = 0;
+
+    if (useCache)
+    {
+        sourceHash = MeshCache::hashFile(filename);
+        sourceHash = MeshCache::hash(&convertToMeters, sizeof(Scalar), sourceHash);
+        sourceHash = MeshCache::hash(&origin.x, sizeof(Scalar), sourceHash);
+        sourceHash = MeshCache::hash(&origin.y, sizeof(Scalar), sourceHash);
+
+        MeshCache cache(cacheFilename, sourceHash);
+
+        if (cache.valid())
+        {
+            comm_->printf("Loading mesh cache \"%s\"...\n", cacheFilename.c_str());
+            init(cache);
+            return;
+        }
+    }
 
     int fileId;
     char name[256];
@@ -49,7 +74,7 @@ CgnsUnstructuredGrid::CgnsUnstructuredGrid(const Input &input)
     printf("Loading zone \"%s\" with %d nodes and %d cells...\n", name, sizes[0], sizes[1]);
 
     //- Read all zone relevant data
-    readNodes(fileId, baseId, zoneId, sizes[0], convertToMeters, input.caseInput().get<std::string>("Grid.origin", "(0,0)"));
+    readNodes(fileId, baseId, zoneId, sizes[0], convertToMeters, origin);
     readElements(fileId, baseId, zoneId);
     readBoundaries(fileId, baseId, zoneId);
 
@@ -57,14 +82,24 @@ CgnsUnstructuredGrid::CgnsUnstructuredGrid(const Input &input)
 
     initConnectivity();
     computeBoundingBox();
+
+    if (useCache && comm_->isMainProc())
+    {
+        comm_->printf("Writing mesh cache \"%s\"...\n", cacheFilename.c_str());
+        MeshCache::write(cacheFilename, sourceHash, *this);
+    }
 }
 
 void CgnsUnstructuredGrid::loadPartitionedGrid(std::shared_ptr<Communicator> comm)
 {
     comm_ = comm;
 
+    const std::string filename = "solution/Proc" + std::to_string(comm_->rank()) + "/Grid.cgns";
+
     int fid;
-    cg_open(("solution/Proc" + std::to_string(comm_->rank()) + "/Grid.cgns").c_str(), CG_MODE_READ, &fid);
+    if (cg_open(filename.c_str(), CG_MODE_READ, &fid) != CG_OK)
+        throw Exception("CgnsUnstructuredGrid", "loadPartitionedGrid",
+                        "could not open partitioned grid \"" + filename + "\".");
 
     int bid = 1, zid = 1, dim[2];
     char name[256];
@@ -90,8 +125,80 @@ void CgnsUnstructuredGrid::loadPartitionedGrid(std::shared_ptr<Communicator> com
     cg_field_read(fid, bid, zid, 1, "ProcNo", CGNS_ENUMV(Integer), &rmin, &rmax, procNo.data());
     cg_field_read(fid, bid, zid, 1, "GlobalID", CGNS_ENUMV(Integer), &rmin, &rmax, globalIds.data());
 
+    //- Grids decomposed offline also store the serial ids of the cells sent to each proc
+    std::vector<std::vector<int>> sendOrders;
+
+    if (cg_goto(fid, bid, "Zone_t", zid, "SendOrders", 0, "end") == CG_OK)
+    {
+        sendOrders.resize(comm_->nProcs());
+
+        int nArrays;
+        cg_narrays(&nArrays);
+
+        for (int arrayId = 1; arrayId <= nArrays; ++arrayId)
+        {
+            CGNS_ENUMT(DataType_t) type;
+            int nDims;
+            cgsize_t dims[12];
+
+            cg_array_info(arrayId, name, &type, &nDims, dims);
+
+            int proc = std::stoi(std::string(name).substr(4));
+
+            if (proc >= comm_->nProcs())
+                throw Exception("CgnsUnstructuredGrid", "loadPartitionedGrid",
+                                "grid was partitioned for more than " + std::to_string(comm_->nProcs()) + " procs.");
+
+            sendOrders[proc].resize(dims[0]);
+            cg_array_read_as(arrayId, CGNS_ENUMV(Integer), sendOrders[proc].data());
+        }
+    }
+
+    //- Serial node and face ids, faces are identified by their local node pairs
+    std::vector<int> serialNodeIds, faceNodeIds, serialFaceIds, nSerialFaces;
+
+    if (cg_goto(fid, bid, "Zone_t", zid, "SerialIds", 0, "end") == CG_OK)
+    {
+        int nArrays;
+        cg_narrays(&nArrays);
+
+        for (int arrayId = 1; arrayId <= nArrays; ++arrayId)
+        {
+            CGNS_ENUMT(DataType_t) type;
+            int nDims;
+            cgsize_t dims[12];
+
+            cg_array_info(arrayId, name, &type, &nDims, dims);
+
+            std::vector<int> &ids = std::string(name) == "Nodes" ? serialNodeIds
+                                    : std::string(name) == "FaceNodes" ? faceNodeIds
+                                    : std::string(name) == "Faces" ? serialFaceIds : nSerialFaces;
+
+            ids.resize(dims[0]);
+            cg_array_read_as(arrayId, CGNS_ENUMV(Integer), ids.data());
+        }
+    }
+
     cg_close(fid);
 
+    globalCellIds_.assign(globalIds.begin(), globalIds.end());
+
+    if (!serialNodeIds.empty())
+    {
+        if (serialNodeIds.size() != nodes_.size() || serialFaceIds.size() != faces_.size()
+            || faceNodeIds.size() != 2 * serialFaceIds.size() || nSerialFaces.size() != 1)
+            throw Exception("CgnsUnstructuredGrid", "loadPartitionedGrid",
+                            "serial ids of partitioned grid \"" + filename + "\" do not match the grid.");
+
+        globalNodeIds_.assign(serialNodeIds.begin(), serialNodeIds.end());
+        globalFaceIds_.resize(faces_.size());
+
+        for (Label i = 0; i < serialFaceIds.size(); ++i)
+            globalFaceIds_[findFace(faceNodeIds[2 * i], faceNodeIds[2 * i + 1])] = serialFaceIds[i];
+
+        nSerialFaces_ = nSerialFaces[0];
+    }
+
     //- Construct the buffer zones
     sendCellGroups_.resize(comm_->nProcs());
     bufferCellZones_.resize(comm_->nProcs());
@@ -104,16 +211,33 @@ void CgnsUnstructuredGrid::loadPartitionedGrid(std::shared_ptr<Communicator> com
 
     //- Construct the buffer regions
     for (const Cell &cell: cells_)
+    {
+        if (procNo[cell.id()] >= comm_->nProcs())
+            throw Exception("CgnsUnstructuredGrid", "loadPartitionedGrid",
+                            "grid was partitioned for more than " + std::to_string(comm_->nProcs()) + " procs.");
+
         if (procNo[cell.id()] != comm_->rank())
             bufferCellZones_[procNo[cell.id()]].add(cell);
+    }
 
     //- Create a global to local id map
     std::unordered_map<int, int> globalToLocalIdMap;
     for (int id = 0; id < globalIds.size(); ++id)
         globalToLocalIdMap[globalIds[id]] = id;
 
+    if (!sendOrders.empty())
+    {
+        for (int proc = 0; proc < comm_->nProcs(); ++proc)
+            for (Label gid: sendOrders[proc])
+                sendCellGroups_[proc].add(cells_[globalToLocalIdMap[gid]]);
+
+        computeGlobalOrdering();
+        return;
+    }
+
     //- Communicate send orders
     std::vector<std::vector<unsigned long>> recvOrders(comm_->nProcs());
+    Communicator::Requests requests;
     for (int proc = 0; proc < comm_->nProcs(); ++proc)
     {
         std::transform(bufferCellZones_[proc].begin(), bufferCellZones_[proc].end(),
@@ -121,7 +245,7 @@ void CgnsUnstructuredGrid::loadPartitionedGrid(std::shared_ptr<Communicator> com
                     return globalIds[cell.id()];
                 });
 
-        comm_->isend(proc, recvOrders[proc], proc);
+        comm_->isend(proc, recvOrders[proc], requests, proc);
     }
 
     for (int proc = 0; proc < comm_->nProcs(); ++proc)
@@ -133,7 +257,7 @@ void CgnsUnstructuredGrid::loadPartitionedGrid(std::shared_ptr<Communicator> com
             sendCellGroups_[proc].add(cells_[globalToLocalIdMap[gid]]);
     }
 
-    comm_->waitAll();
+    comm_->waitAll(requests);
     computeGlobalOrdering();
 }
 
@@ -1,23 +1,64 @@
 #include <string>
 
+#include <boost/filesystem.hpp>
+
 #include "ConstructGrid.h"
 #include "StructuredRectilinearGrid.h"
 #include "CgnsUnstructuredGrid.h"
 #include "Exception.h"
+#include "Checkpoint.h"
 
 std::shared_ptr<FiniteVolumeGrid2D> constructGrid(const Input &input, std::shared_ptr<Communicator> comm)
 {
     using namespace std;
 
-    //- Check if a grid needs to be loaded
+    //- Check if a grid needs to be loaded. Restarts on a different number of procs rebuild the grid from its
+    //- input and partition it, the checkpoint is then redistributed by serial id. Without a checkpoint, the
+    //- partitioned grid written with the CGNS solution is used. Only the CGNS viewer writes the partitioned grid,
+    //- so when it is missing the grid is also rebuilt and the checkpoint redistributed
     if (input.initialConditionInput().get<std::string>("InitialConditions.type", "") == "restart")
+    {
+        bool sameNProcs = true;
+
+        if (CheckpointHeader::exists())
+        {
+            std::ifstream fin;
+            CheckpointHeader::open(0, fin);
+            sameNProcs = CheckpointHeader(fin).nProcs == comm->nProcs();
+        }
+
+        std::string filename = "solution/Proc" + std::to_string(comm->rank()) + "/Grid.cgns";
+        bool hasPartitionedGrid = comm->min((int) boost::filesystem::exists(filename));
+
+        if (sameNProcs && (hasPartitionedGrid || !CheckpointHeader::exists()))
+        {
+            auto grid = std::make_shared<CgnsUnstructuredGrid>();
+            grid->loadPartitionedGrid(comm);
+            grid->initHaloExchange(input);
+            return grid;
+        }
+    }
+
+    //- Grids decomposed offline by phasePartitionMesh are loaded directly by each proc
+    if (input.caseInput().get<bool>("Grid.partitioned", false))
     {
         auto grid = std::make_shared<CgnsUnstructuredGrid>();
         grid->loadPartitionedGrid(comm);
+        grid->initHaloExchange(input);
         return grid;
     }
 
     //- Grid must be constructed
+    auto grid = constructSerialGrid(input);
+    grid->partition(input, comm);
+
+    return grid;
+}
+
+std::shared_ptr<FiniteVolumeGrid2D> constructSerialGrid(const Input &input)
+{
+    using namespace std;
+
     string gridType = input.caseInput().get<string>("Grid.type");
     Point2D origin = input.caseInput().get<string>("Grid.origin", "(0,0)");
 
@@ -44,17 +85,14 @@ std::shared_ptr<FiniteVolumeGrid2D> constructGrid(const Input &input, std::share
                                                                 yDimRefinements,
                                                                 origin);
 
-        grid->partition(input, comm);
         return grid;
     }
     else if (gridType == "cgns")
     {
-        auto grid = std::make_shared<CgnsUnstructuredGrid>(input);
-        grid->partition(input, comm);
-        return grid;
+        return std::make_shared<CgnsUnstructuredGrid>(input);
     }
     else
     {
-        throw Exception("", "constructGrid", "invalid grid type \"" + gridType + "\".");
+        throw Exception("", "constructSerialGrid", "invalid grid type \"" + gridType + "\".");
     }
 }
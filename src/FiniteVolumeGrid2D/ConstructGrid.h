@@ -8,4 +8,7 @@
 
 std::shared_ptr<FiniteVolumeGrid2D> constructGrid(const Input &input, std::shared_ptr<Communicator> comm);
 
+//- The complete grid described by the case input, without partitioning
+std::shared_ptr<FiniteVolumeGrid2D> constructSerialGrid(const Input &input);
+
 #endif
@@ -1,9 +1,12 @@
 #include <numeric>
+#include <set>
+#include <unordered_set>
 
 #include <cgnslib.h>
-#include <metis.h>
+#include <parmetis.h>
 
 #include "FiniteVolumeGrid2D.h"
+#include "MeshCache.h"
 
 FiniteVolumeGrid2D::FiniteVolumeGrid2D()
         :
@@ -61,6 +64,67 @@ void FiniteVolumeGrid2D::init(const std::vector<Point2D> &nodes,
     computeBoundingBox();
 }
 
+void FiniteVolumeGrid2D::init(const MeshCache &cache)
+{
+    reset();
+
+    const auto &coords = cache.nodes();
+    const auto &cellInds = cache.cellInds();
+    const auto &cellNodeIds = cache.cellNodeIds();
+    const auto &faceNodeIds = cache.faceNodeIds();
+    const auto &faceCellIds = cache.faceCellIds();
+
+    nodes_.reserve(coords.size() / 2);
+    cells_.reserve(cellInds.size() - 1);
+    faces_.reserve(faceNodeIds.size() / 2);
+
+    for (Label i = 0; i < coords.size(); i += 2)
+        addNode(Point2D(coords[i], coords[i + 1]));
+
+    for (Label i = 0; i < cellInds.size() - 1; ++i)
+    {
+        std::vector<Label> ids(cellNodeIds.begin() + cellInds[i], cellNodeIds.begin() + cellInds[i + 1]);
+        cells_.push_back(Cell(ids, *this));
+
+        for (Label id: ids)
+            nodes_[id].addCell(cells_.back());
+    }
+
+    //- Faces are created in the same order as createCell, the directory is built from its sorted keys
+    for (Label i = 0; i < faceNodeIds.size(); i += 2)
+    {
+        bool isBoundary = faceCellIds[i + 1] == MeshCache::none;
+        faces_.push_back(Face(faceNodeIds[i], faceNodeIds[i + 1], *this, isBoundary ? Face::BOUNDARY : Face::INTERIOR));
+        faces_.back().addCell(cells_[faceCellIds[i]]);
+
+        if (!isBoundary)
+            faces_.back().addCell(cells_[faceCellIds[i + 1]]);
+    }
+
+    for (Label id: cache.sortedFaceIds())
+    {
+        Label n1 = faceNodeIds[2 * id], n2 = faceNodeIds[2 * id + 1];
+        faceDirectory_.emplace_hint(faceDirectory_.end(), n1 < n2 ? std::make_pair(n1, n2) : std::make_pair(n2, n1), id);
+    }
+
+    initNodes();
+    initFaceLinks();
+
+    const auto &diagonalInds = cache.diagonalInds();
+    const auto &diagonalCellIds = cache.diagonalCellIds();
+
+    for (Cell &cell: cells_)
+        for (Label i = diagonalInds[cell.id()]; i < diagonalInds[cell.id() + 1]; ++i)
+            cell.addDiagonalLink(cells_[diagonalCellIds[i]]);
+
+    setCellsActive(cells_.begin(), cells_.end());
+
+    for (const MeshCache::PatchData &patch: cache.patches())
+        createPatch(patch.name, std::vector<Label>(patch.faceIds.begin(), patch.faceIds.end()));
+
+    computeBoundingBox();
+}
+
 void FiniteVolumeGrid2D::reset()
 {
     //- Node related data
@@ -87,6 +151,20 @@ void FiniteVolumeGrid2D::reset()
     //- Communication zones
     sendCellGroups_.clear(); // shared pointers are used so that zones can be moveable!
     bufferCellZones_.clear();
+    neighbourComm_.reset();
+    neighbourSources_.clear();
+    neighbourDestinations_.clear();
+    haloWindow_.reset();
+    nodeComm_.reset();
+    nodeRanks_.clear();
+    haloExportOffsets_.clear();
+    haloImportLocations_.clear();
+    haloExportSize_ = 0;
+
+    //- Local to serial id maps
+    globalCellIds_.clear();
+    globalFaceIds_.clear();
+    globalNodeIds_.clear();
 
     //- Face related data
     faces_.clear();
@@ -373,6 +451,53 @@ std::vector<Ref<const Node>> FiniteVolumeGrid2D::findNearestNodes(const Point2D
     return nodeGroup_.nearestItems(pt, nNodes);
 }
 
+const Cell *FiniteVolumeGrid2D::findContainingCell(const Point2D &pt, const Cell *hint) const
+{
+    if (cells_.empty())
+        return nullptr;
+
+    const Cell *cell = hint ? walk(pt, *hint) : nullptr;
+
+    if (cell)
+        return cell;
+
+    //- A walk can be blocked by a concave boundary, restart it from a cell of the nearest node
+    const Node &node = findNearestNode(pt);
+
+    return node.cellIds().empty() ? nullptr : walk(pt, cells_[node.cellIds()[0]]);
+}
+
+std::vector<const Cell *> FiniteVolumeGrid2D::findContainingCells(const std::vector<Point2D> &pts,
+                                                                  const Cell *hint) const
+{
+    std::vector<const Cell *> cells;
+    cells.reserve(pts.size());
+
+    for (const Point2D &pt: pts)
+    {
+        cells.push_back(findContainingCell(pt, hint));
+        hint = cells.back() ? cells.back() : hint;
+    }
+
+    return cells;
+}
+
+const Node &FiniteVolumeGrid2D::findNearestNode(const Point2D &pt, const Cell *hint) const
+{
+    const Cell *cell = findContainingCell(pt, hint);
+
+    if (!cell)
+        return findNearestNode(pt);
+
+    Label nearestId = cell->nodeIds()[0];
+
+    for (Label id: cell->nodeIds())
+        if ((nodes_[id] - pt).magSqr() < (nodes_[nearestId] - pt).magSqr())
+            nearestId = id;
+
+    return nodes_[nearestId];
+}
+
 std::pair<std::vector<int>, std::vector<int> > FiniteVolumeGrid2D::nodeElementConnectivity() const
 {
     using namespace std;
@@ -399,90 +524,103 @@ void FiniteVolumeGrid2D::partition(const Input &input, std::shared_ptr<Communica
         return;
 
     comm_->printf("Partitioning grid into %d partitions...\n", comm_->nProcs());
-    vector<idx_t> cellPartition(nCells());
+    vector<int> cellPartition(nCells());
 
     if (comm_->isMainProc()) // partition is performed on main proc
     {
-        idx_t nPartitions = comm_->nProcs();
-        idx_t nElems = nCells();
-        pair<vector<int>, vector<int>> mesh = nodeElementConnectivity();
-        idx_t nNodes = this->nNodes();
-        idx_t nCommon = 2; //- face connectivity weighting only
-        idx_t objVal;
-        vector<idx_t> nodePartition(this->nNodes());
-
-        int status = METIS_PartMeshDual(&nElems, &nNodes,
-                                        mesh.first.data(), mesh.second.data(),
-                                        NULL, NULL,
-                                        &nCommon, &nPartitions,
-                                        NULL, NULL, &objVal,
-                                        cellPartition.data(), nodePartition.data());
-        if (status == METIS_OK)
-            comm_->printf("Sucessfully computed partitioning.\n");
-        else
-            throw Exception("FiniteVolumeGrid2D", "partition", "an error occurred during partitioning.");
+        cellPartition = computePartition(comm_->nProcs());
+        comm_->printf("Sucessfully computed partitioning.\n");
     }
 
     //- Broadcast the partitioning to other processes
     comm_->broadcast(comm_->mainProcNo(), cellPartition);
 
+    initLocalDomain(input, cellPartition);
+}
+
+std::vector<int> FiniteVolumeGrid2D::computePartition(int nPartitions) const
+{
+    using namespace std;
+
+    idx_t nParts = nPartitions;
+    idx_t nElems = nCells();
+    pair<vector<int>, vector<int>> mesh = nodeElementConnectivity();
+    idx_t nNodes = this->nNodes();
+    idx_t nCommon = 2; //- face connectivity weighting only
+    idx_t objVal;
+    vector<idx_t> cellPartition(nCells()), nodePartition(this->nNodes());
+
+    int status = METIS_PartMeshDual(&nElems, &nNodes,
+                                    mesh.first.data(), mesh.second.data(),
+                                    NULL, NULL,
+                                    &nCommon, &nParts,
+                                    NULL, NULL, &objVal,
+                                    cellPartition.data(), nodePartition.data());
+
+    if (status != METIS_OK)
+        throw Exception("FiniteVolumeGrid2D", "computePartition", "an error occurred during partitioning.");
+
+    return vector<int>(cellPartition.begin(), cellPartition.end());
+}
+
+FiniteVolumeGrid2D::LocalDomain FiniteVolumeGrid2D::localDomain(const std::vector<int> &cellPartition,
+                                                                 int proc,
+                                                                 Scalar minBufferWidth) const
+{
+    using namespace std;
+
     //- Criteria to see if a cell is retained on a particular proc
-    auto addCellToThisProc = [this, &cellPartition](const Cell &cell, Scalar r = 0.) -> bool {
-        if (cellPartition[cell.id()] == comm_->rank())
+    auto addCellToProc = [&cellPartition, proc, this](const Cell &cell, Scalar r) -> bool {
+        if (cellPartition[cell.id()] == proc)
             return true;
 
         for (const InteriorLink &nb: cell.neighbours())
-            if (cellPartition[nb.cell().id()] == comm_->rank())
+            if (cellPartition[nb.cell().id()] == proc)
                 return true;
 
         for (const CellLink &dg: cell.diagonals())
-            if (cellPartition[dg.cell().id()] == comm_->rank())
+            if (cellPartition[dg.cell().id()] == proc)
                 return true;
 
         for (const Cell &kCell: globalActiveCells_.itemsWithin(Circle(cell.centroid(), r)))
-            if (cellPartition[kCell.id()] == comm_->rank())
+            if (cellPartition[kCell.id()] == proc)
                 return true;
 
         return false;
     };
 
     //- Construct the crs representation of the local grid
-    comm_->printf("Computing the local cell domains...\n");
-    vector<Point2D> nodes;
-    vector<Label> cellInds(1, 0), cellNodeIds, cellProc;
-    unordered_map<Label, Label> cellGlobalToLocalIdMap, cellLocalToGlobalIdMap;
+    LocalDomain domain;
+    domain.cellInds.push_back(0);
     vector<int> localNodeId(nodes_.size(), -1);
-    Scalar r = input.caseInput().get<Scalar>("Grid.minBufferWidth",
-                                             0.); //- May be important for algorithms requiring spatial searches
 
     for (const Cell &cell: cells_)
     {
-        if (addCellToThisProc(cell, r))
+        if (addCellToProc(cell, minBufferWidth))
         {
-            cellInds.push_back(cellInds.back() + cell.nodes().size());
-            cellProc.push_back(cellPartition[cell.id()]);
-
-            cellGlobalToLocalIdMap[cell.id()] = cellInds.size() - 2;
-            cellLocalToGlobalIdMap[cellInds.size() - 2] = cell.id();
+            domain.cellInds.push_back(domain.cellInds.back() + cell.nodes().size());
+            domain.cellProc.push_back(cellPartition[cell.id()]);
+            domain.globalCellIds.push_back(cell.id());
 
             for (const Node &node: cell.nodes())
             {
                 if (localNodeId[node.id()] == -1)
                 {
-                    localNodeId[node.id()] = nodes.size();
-                    nodes.push_back(node);
+                    localNodeId[node.id()] = domain.nodes.size();
+                    domain.nodes.push_back(node);
+                    domain.globalNodeIds.push_back(node.id());
                 }
 
-                cellNodeIds.push_back(localNodeId[node.id()]);
+                domain.cellNodeIds.push_back(localNodeId[node.id()]);
             }
         }
     }
 
-    //- Boundary patches
-    comm_->printf("Computing the local boundary patches...\n");
-    std::unordered_map<std::string, std::vector<Label>> localPatches;
+    //- Boundary patches, all patches are created (even if empty) in order of their ids so that ids match on all procs
+    vector<Ref<const Patch>> patches = this->patches();
+    std::sort(patches.begin(), patches.end(), [](const Patch &lhs, const Patch &rhs) { return lhs.id() < rhs.id(); });
 
-    for (const Patch &patch: patches())
+    for (const Patch &patch: patches)
     {
         vector<Label> nodeIds;
 
@@ -498,58 +636,46 @@ void FiniteVolumeGrid2D::partition(const Input &input, std::shared_ptr<Communica
             }
         }
 
-        if (!nodeIds.empty())
-            localPatches[patch.name()] = nodeIds;
+        domain.patches.push_back(make_pair(patch.name(), nodeIds));
     }
 
-    //- Now re-initialize local domains
-    comm_->printf("Initializing local domains...\n");
-    init(nodes, cellInds, cellNodeIds, Point2D(0., 0.));
-    for (const auto &patch: localPatches)
-        createPatchByNodes(patch.first, patch.second);
-
-    comm_->printf("Finished initializing local domains.\n");
+    return domain;
+}
 
-    //- Interprocess communication zones
-    comm_->printf("Initializing interprocess communication buffers...\n");
-    sendCellGroups_.resize(comm_->nProcs());
-    bufferCellZones_.resize(comm_->nProcs());
+void FiniteVolumeGrid2D::initLocalDomain(const Input &input, const std::vector<int> &cellPartition)
+{
+    using namespace std;
 
-    for (int proc = 0; proc < comm_->nProcs(); ++proc)
-    {
-        sendCellGroups_[proc] = CellGroup("Proc" + std::to_string(proc));
-        bufferCellZones_[proc] = CellZone("Proc" + std::to_string(proc), localActiveCells_.registry());
-    }
+    comm_->printf("Computing the local cell domains...\n");
+    Scalar r = input.caseInput().get<Scalar>("Grid.minBufferWidth",
+                                             0.); //- May be important for algorithms requiring spatial searches
 
-    //- Identify buffer regions
-    for (const Cell &cell: cells_)
-        if (cellProc[cell.id()] != comm_->rank())
-            bufferCellZones_[cellProc[cell.id()]].add(cell);
+    LocalDomain domain = localDomain(cellPartition, comm_->rank(), r);
 
-    //- Initialize all buffers
-    std::vector<std::vector<unsigned long>> recvOrders(comm_->nProcs());
+    //- The serial face directory is needed to find the serial ids of the local faces
+    auto serialFaceDirectory = std::move(faceDirectory_);
+    Size nSerialFaces = faces_.size();
 
-    for (int proc = 0; proc < comm_->nProcs(); ++proc)
-    {
-        std::transform(bufferCellZones_[proc].begin(), bufferCellZones_[proc].end(),
-                       std::back_inserter(recvOrders[proc]), [&cellLocalToGlobalIdMap](const Cell &cell) {
-                    return cellLocalToGlobalIdMap[cell.id()];
-                });
+    //- Now re-initialize local domains
+    comm_->printf("Initializing local domains...\n");
+    init(domain.nodes, domain.cellInds, domain.cellNodeIds, Point2D(0., 0.));
+    for (const auto &patch: domain.patches)
+        createPatchByNodes(patch.first, patch.second);
 
-        comm_->isend(proc, recvOrders[proc], proc);
-    }
+    nSerialFaces_ = nSerialFaces;
+    globalCellIds_ = std::move(domain.globalCellIds);
+    globalNodeIds_ = std::move(domain.globalNodeIds);
+    globalFaceIds_.resize(faces_.size());
 
-    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    for (const Face &face: faces_)
     {
-        std::vector<unsigned long> sendOrder(comm_->probeSize<unsigned long>(proc, comm_->rank()));
-        comm_->recv(proc, sendOrder, comm_->rank());
-
-        for (Label gid: sendOrder)
-            sendCellGroups_[proc].add(cells_[cellGlobalToLocalIdMap[gid]]);
+        Label n1 = globalNodeIds_[face.lNode().id()], n2 = globalNodeIds_[face.rNode().id()];
+        globalFaceIds_[face.id()] = serialFaceDirectory[n1 < n2 ? make_pair(n1, n2) : make_pair(n2, n1)];
     }
 
-    comm_->waitAll();
-    computeGlobalOrdering();
+    comm_->printf("Finished initializing local domains.\n");
+
+    initBuffers(input, domain.cellProc);
 }
 
 void FiniteVolumeGrid2D::computeGlobalOrdering()
@@ -613,8 +739,510 @@ void FiniteVolumeGrid2D::computeParMetisGlobalOrdering()
 
 }
 
+void FiniteVolumeGrid2D::repartition(const Input &input, const std::vector<Scalar> &cellWeights)
+{
+    using namespace std;
+
+    if (!comm_ || comm_->nProcs() == 1)
+        return;
+
+    if (!canRepartition())
+        throw Exception("FiniteVolumeGrid2D", "repartition",
+                        "the serial ids of the local cells, faces and nodes are not available.");
+
+    comm_->printf("Repartitioning grid...\n");
+
+    //- Construct the distributed dual graph of the cells owned by this proc
+    vector<int> cellOwner = cellOwnership();
+    vector<Label> localCells;
+
+    for (const Cell &cell: cells_)
+        if (cellOwner[cell.id()] == comm_->rank())
+            localCells.push_back(cell.id());
+
+    vector<idx_t> vtxDist(1, 0);
+    for (unsigned long nVtx: comm_->allGather((unsigned long) localCells.size()))
+        vtxDist.push_back(vtxDist.back() + nVtx);
+
+    vector<int> vtxIds(nCells(), -1);
+    for (Label i = 0; i < localCells.size(); ++i)
+        vtxIds[localCells[i]] = vtxDist[comm_->rank()] + i;
+
+    sendMessages(vtxIds);
+
+    vector<idx_t> xAdj(1, 0), adjncy, vWgt, vSize(localCells.size(), 1);
+
+    //- ParMETIS requires integer weights, scale so that fractional weights are resolved
+    const Scalar weightScale = 100.;
+
+    for (Label id: localCells)
+    {
+        for (const InteriorLink &nb: cells_[id].neighbours())
+            adjncy.push_back(vtxIds[nb.cell().id()]);
+
+        xAdj.push_back(adjncy.size());
+        vWgt.push_back(std::max((idx_t) std::round(weightScale * cellWeights[id]), (idx_t) 1));
+    }
+
+    idx_t wgtFlag = 2, numFlag = 0, nCon = 1, nParts = comm_->nProcs(), edgeCut;
+    idx_t options[] = {1, 0, 0, PARMETIS_PSR_COUPLED};
+    real_t itr = input.caseInput().get<real_t>("System.loadBalancing.itr", 1000.);
+    real_t ubVec = input.caseInput().get<real_t>("System.loadBalancing.tolerance", 1.05);
+    vector<real_t> tpWgts(nParts, 1. / nParts);
+    vector<idx_t> part(localCells.size());
+    MPI_Comm mpiComm = comm_->communicator();
+
+    int status = ParMETIS_V3_AdaptiveRepart(vtxDist.data(), xAdj.data(), adjncy.data(),
+                                            vWgt.data(), vSize.data(), NULL,
+                                            &wgtFlag, &numFlag, &nCon, &nParts,
+                                            tpWgts.data(), &ubVec, &itr, options,
+                                            &edgeCut, part.data(), &mpiComm);
+
+    if (status != METIS_OK)
+        throw Exception("FiniteVolumeGrid2D", "repartition", "an error occurred during repartitioning.");
+
+    //- New owners of all local cells, buffers included
+    vector<int> newOwner(nCells(), -1);
+    for (Label i = 0; i < localCells.size(); ++i)
+        newOwner[localCells[i]] = part[i];
+
+    sendMessages(newOwner);
+
+    //- A cell is sent to the procs whose new local domain contains it, ie its new owner and the new owners of the
+    //  cells it buffers. These cells are all in the local domain of the current owner
+    Scalar r = input.caseInput().get<Scalar>("Grid.minBufferWidth", 0.);
+    CellGroup allCells;
+
+    if (r > 0.)
+        allCells.add(cells_.begin(), cells_.end());
+
+    vector<vector<Label>> sendCells(comm_->nProcs());
+
+    for (Label id: localCells)
+    {
+        const Cell &cell = cells_[id];
+        set<int> procs = {newOwner[id]};
+
+        for (const InteriorLink &nb: cell.neighbours())
+            procs.insert(newOwner[nb.cell().id()]);
+
+        for (const CellLink &dg: cell.diagonals())
+            procs.insert(newOwner[dg.cell().id()]);
+
+        if (r > 0.)
+            for (const Cell &kCell: allCells.itemsWithin(Circle(cell.centroid(), r)))
+                procs.insert(newOwner[kCell.id()]);
+
+        for (int proc: procs)
+            sendCells[proc].push_back(id);
+    }
+
+    //- User defined zones/groups are referenced externally, so the objects are retained and their membership is
+    //  migrated with the cells. Sorted by name so that the exchanges are consistently ordered
+    map<string, shared_ptr<CellZone>> cellZones(cellZones_.begin(), cellZones_.end());
+    map<string, shared_ptr<CellGroup>> cellGroups(cellGroups_.begin(), cellGroups_.end());
+    vector<vector<int>> zoneMembership, groupMembership;
+
+    for (const auto &zone: cellZones)
+    {
+        zoneMembership.push_back(vector<int>(nCells(), 0));
+        for (const Cell &cell: *zone.second)
+            zoneMembership.back()[cell.id()] = 1;
+
+        zone.second->clear();
+    }
+
+    for (const auto &group: cellGroups)
+    {
+        groupMembership.push_back(vector<int>(nCells(), 0));
+        for (const Cell &cell: *group.second)
+            groupMembership.back()[cell.id()] = 1;
+
+        group.second->clear();
+    }
+
+    comm_->printf("Migrating cells...\n");
+    migrateLocalDomain(input, newOwner, sendCells);
+
+    int i = 0;
+    for (auto &zone: cellZones)
+    {
+        cellZones_[zone.first] = zone.second;
+        vector<int> isMember = migrateCellData(zoneMembership[i++]);
+
+        for (const Cell &cell: localActiveCells_)
+            if (isMember[cell.id()])
+                zone.second->add(cell);
+    }
+
+    i = 0;
+    for (auto &group: cellGroups)
+    {
+        cellGroups_[group.first] = group.second;
+        vector<int> isMember = migrateCellData(groupMembership[i++]);
+
+        for (const Cell &cell: localActiveCells_)
+            if (isMember[cell.id()])
+                group.second->add(cell);
+    }
+
+    comm_->printf("Finished repartitioning.\n");
+}
+
 //- Protected methods
 
+void FiniteVolumeGrid2D::initBuffers(const Input &input, const std::vector<Label> &cellProc)
+{
+    using namespace std;
+
+    //- Interprocess communication zones
+    comm_->printf("Initializing interprocess communication buffers...\n");
+    sendCellGroups_.resize(comm_->nProcs());
+    bufferCellZones_.resize(comm_->nProcs());
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        sendCellGroups_[proc] = CellGroup("Proc" + std::to_string(proc));
+        bufferCellZones_[proc] = CellZone("Proc" + std::to_string(proc), localActiveCells_.registry());
+    }
+
+    //- Identify buffer regions
+    for (const Cell &cell: cells_)
+        if (cellProc[cell.id()] != comm_->rank())
+            bufferCellZones_[cellProc[cell.id()]].add(cell);
+
+    unordered_map<Label, Label> cellGlobalToLocalIdMap;
+    for (Label id = 0; id < globalCellIds_.size(); ++id)
+        cellGlobalToLocalIdMap[globalCellIds_[id]] = id;
+
+    //- Initialize all buffers
+    std::vector<std::vector<unsigned long>> recvOrders(comm_->nProcs());
+    Communicator::Requests requests;
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        std::transform(bufferCellZones_[proc].begin(), bufferCellZones_[proc].end(),
+                       std::back_inserter(recvOrders[proc]), [this](const Cell &cell) {
+                    return globalCellIds_[cell.id()];
+                });
+
+        comm_->isend(proc, recvOrders[proc], requests, proc);
+    }
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        std::vector<unsigned long> sendOrder(comm_->probeSize<unsigned long>(proc, comm_->rank()));
+        comm_->recv(proc, sendOrder, comm_->rank());
+
+        for (Label gid: sendOrder)
+            sendCellGroups_[proc].add(cells_[cellGlobalToLocalIdMap[gid]]);
+    }
+
+    comm_->waitAll(requests);
+    initHaloExchange(input);
+    computeGlobalOrdering();
+}
+
+void FiniteVolumeGrid2D::migrateLocalDomain(const Input &input,
+                                            const std::vector<int> &newOwner,
+                                            const std::vector<std::vector<Label>> &sendCells)
+{
+    using namespace std;
+
+    //- Each cell is sent with its serial id, new owner, nodes and faces. Faces are given by their serial id, serial
+    //  node ids and patch (patch id + 1, or 0 for interior faces). Node and face data is migrated in the order in
+    //  which they first appear in the sent cells
+    vector<vector<unsigned long>> sendBuffers(comm_->nProcs());
+    vector<vector<Vector2D>> sendCoords(comm_->nProcs());
+    Communicator::Requests requests;
+
+    cellMigration_.sendIds = sendCells;
+    faceMigration_.sendIds.assign(comm_->nProcs(), vector<Label>());
+    nodeMigration_.sendIds.assign(comm_->nProcs(), vector<Label>());
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        vector<unsigned long> &buffer = sendBuffers[proc];
+        unordered_set<Label> sentFaces, sentNodes;
+
+        auto addFace = [&](const Face &face, unsigned long patchNo) {
+            buffer.push_back(globalFaceIds_[face.id()]);
+            buffer.push_back(globalNodeIds_[face.lNode().id()]);
+            buffer.push_back(globalNodeIds_[face.rNode().id()]);
+            buffer.push_back(patchNo);
+
+            if (sentFaces.insert(face.id()).second)
+                faceMigration_.sendIds[proc].push_back(face.id());
+        };
+
+        for (Label id: sendCells[proc])
+        {
+            const Cell &cell = cells_[id];
+
+            buffer.push_back(globalCellIds_[id]);
+            buffer.push_back(newOwner[id]);
+            buffer.push_back(cell.nodeIds().size());
+
+            for (Label nodeId: cell.nodeIds())
+            {
+                buffer.push_back(globalNodeIds_[nodeId]);
+                sendCoords[proc].push_back(nodes_[nodeId]);
+
+                if (sentNodes.insert(nodeId).second)
+                    nodeMigration_.sendIds[proc].push_back(nodeId);
+            }
+
+            buffer.push_back(cell.neighbours().size() + cell.boundaries().size());
+
+            for (const InteriorLink &nb: cell.neighbours())
+                addFace(nb.face(), 0);
+
+            for (const BoundaryLink &bd: cell.boundaries())
+                addFace(bd.face(), patch(bd.face()).id() + 1);
+        }
+
+        comm_->isend(proc, buffer, requests, comm_->rank());
+        comm_->isend(proc, sendCoords[proc], requests, comm_->rank());
+    }
+
+    //- Receive the cells of the new local domain
+    struct CellRecord
+    {
+        int proc;
+        Label pos, coordPos;
+        vector<unsigned long>::const_iterator data;
+    };
+
+    vector<vector<unsigned long>> recvBuffers(comm_->nProcs());
+    vector<vector<Vector2D>> recvCoords(comm_->nProcs());
+    vector<CellRecord> records;
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        recvBuffers[proc].resize(comm_->probeSize<unsigned long>(proc, proc));
+        comm_->recv(proc, recvBuffers[proc], proc);
+        recvCoords[proc].resize(comm_->probeSize<Vector2D>(proc, proc));
+        comm_->recv(proc, recvCoords[proc], proc);
+
+        Label pos = 0, coordPos = 0;
+        for (auto it = recvBuffers[proc].cbegin(); it != recvBuffers[proc].cend();)
+        {
+            records.push_back(CellRecord{proc, pos++, coordPos, it});
+            coordPos += it[2];
+            it += 3 + it[2];
+            it += 1 + 4 * it[0];
+        }
+    }
+
+    comm_->waitAll(requests);
+
+    //- Cells are ordered by serial id, as they are by the initial partition
+    std::sort(records.begin(), records.end(), [](const CellRecord &lhs, const CellRecord &rhs) {
+        return lhs.data[0] < rhs.data[0];
+    });
+
+    //- All patches are recreated in order of their ids so that ids match on all procs
+    vector<Ref<const Patch>> patches = this->patches();
+    std::sort(patches.begin(), patches.end(), [](const Patch &lhs, const Patch &rhs) { return lhs.id() < rhs.id(); });
+
+    vector<pair<string, vector<Label>>> localPatches;
+    for (const Patch &patch: patches)
+        localPatches.push_back(make_pair(patch.name(), vector<Label>()));
+
+    vector<Point2D> nodes;
+    vector<Label> cellInds(1, 0), cellNodeIds, cellProc, globalCellIds, globalNodeIds;
+    unordered_map<Label, Label> nodeLocalIds;
+    map<pair<Label, Label>, Label> faceSerialIds;
+
+    cellMigration_.recvIds.assign(comm_->nProcs(), vector<Label>());
+
+    for (const CellRecord &record: records)
+        cellMigration_.recvIds[record.proc].push_back(0);
+
+    for (Label id = 0; id < records.size(); ++id)
+    {
+        const CellRecord &record = records[id];
+        auto it = record.data;
+
+        cellMigration_.recvIds[record.proc][record.pos] = id;
+        globalCellIds.push_back(it[0]);
+        cellProc.push_back(it[1]);
+        cellInds.push_back(cellInds.back() + it[2]);
+
+        for (Label i = 0, nNodes = it[2]; i < nNodes; ++i)
+        {
+            auto insert = nodeLocalIds.insert(make_pair(it[3 + i], nodes.size()));
+
+            if (insert.second)
+            {
+                nodes.push_back(recvCoords[record.proc][record.coordPos + i]);
+                globalNodeIds.push_back(it[3 + i]);
+            }
+
+            cellNodeIds.push_back(insert.first->second);
+        }
+
+        it += 3 + it[2];
+
+        for (Label i = 0, nFaces = *it++; i < nFaces; ++i, it += 4)
+        {
+            Label n1 = it[1], n2 = it[2];
+            faceSerialIds[n1 < n2 ? make_pair(n1, n2) : make_pair(n2, n1)] = it[0];
+
+            if (it[3] > 0)
+            {
+                localPatches[it[3] - 1].second.push_back(nodeLocalIds[n1]);
+                localPatches[it[3] - 1].second.push_back(nodeLocalIds[n2]);
+            }
+        }
+    }
+
+    comm_->printf("Initializing local domains...\n");
+    init(nodes, cellInds, cellNodeIds, Point2D(0., 0.));
+    for (const auto &patch: localPatches)
+        createPatchByNodes(patch.first, patch.second);
+
+    globalCellIds_ = std::move(globalCellIds);
+    globalNodeIds_ = std::move(globalNodeIds);
+    globalFaceIds_.resize(faces_.size());
+
+    for (const Face &face: faces_)
+    {
+        Label n1 = globalNodeIds_[face.lNode().id()], n2 = globalNodeIds_[face.rNode().id()];
+        globalFaceIds_[face.id()] = faceSerialIds[n1 < n2 ? make_pair(n1, n2) : make_pair(n2, n1)];
+    }
+
+    //- Node and face data is received in the order it was sent
+    faceMigration_.recvIds.assign(comm_->nProcs(), vector<Label>());
+    nodeMigration_.recvIds.assign(comm_->nProcs(), vector<Label>());
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        unordered_set<Label> recvFaces, recvNodes;
+
+        for (Label id: cellMigration_.recvIds[proc])
+        {
+            auto it = records[id].data;
+
+            for (Label i = 0, nNodes = it[2]; i < nNodes; ++i)
+                if (recvNodes.insert(it[3 + i]).second)
+                    nodeMigration_.recvIds[proc].push_back(nodeLocalIds[it[3 + i]]);
+
+            it += 3 + it[2];
+
+            for (Label i = 0, nFaces = *it++; i < nFaces; ++i, it += 4)
+                if (recvFaces.insert(it[0]).second)
+                    faceMigration_.recvIds[proc].push_back(findFace(nodeLocalIds[it[1]], nodeLocalIds[it[2]]));
+        }
+    }
+
+    comm_->printf("Finished initializing local domains.\n");
+
+    initBuffers(input, cellProc);
+}
+
+void FiniteVolumeGrid2D::initHaloExchange(const Input &input)
+{
+    std::string type = input.caseInput().get<std::string>("System.haloExchange", "pointToPoint");
+
+    neighbourComm_.reset();
+    neighbourSources_.clear();
+    neighbourDestinations_.clear();
+    haloWindow_.reset();
+    nodeComm_.reset();
+    nodeRanks_.clear();
+    haloExportOffsets_.clear();
+    haloImportLocations_.clear();
+    haloExportSize_ = 0;
+
+    if (type == "pointToPoint" || !comm_ || comm_->nProcs() == 1)
+        return;
+    else if (type == "sharedMemory")
+    {
+        initSharedMemoryHalo();
+        return;
+    }
+    else if (type != "neighbourhood")
+        throw Exception("FiniteVolumeGrid2D", "initHaloExchange", "invalid halo exchange type \"" + type + "\".");
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        if (!bufferCellZones_[proc].empty())
+            neighbourSources_.push_back(proc);
+
+        if (!sendCellGroups_[proc].empty())
+            neighbourDestinations_.push_back(proc);
+    }
+
+    neighbourComm_ = comm_->createDistGraph(neighbourSources_, neighbourDestinations_);
+}
+
+void FiniteVolumeGrid2D::initSharedMemoryHalo()
+{
+    nodeComm_ = comm_->splitShared();
+
+    nodeRanks_.assign(comm_->nProcs(), -1);
+    std::vector<int> nodeProcs = nodeComm_->allGather(comm_->rank());
+
+    for (int nodeRank = 0; nodeRank < nodeProcs.size(); ++nodeRank)
+        nodeRanks_[nodeProcs[nodeRank]] = nodeRank;
+
+    //- Each on node neighbour is assigned a section of this proc's export buffer
+    haloExportOffsets_.assign(comm_->nProcs(), 0);
+    haloExportSize_ = 0;
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+        if (nodeRanks_[proc] != -1 && !sendCellGroups_[proc].empty())
+        {
+            haloExportOffsets_[proc] = haloExportSize_;
+            haloExportSize_ += sendCellGroups_[proc].size() * haloSlotSize_;
+        }
+
+    //- Neighbours need the location of their section and the size of the export buffer
+    std::vector<std::vector<unsigned long>> exportLocations(comm_->nProcs()), importLocations(comm_->nProcs());
+    Communicator::Requests requests;
+
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        if (nodeRanks_[proc] == -1)
+            continue;
+
+        if (!bufferCellZones_[proc].empty())
+        {
+            importLocations[proc].resize(2);
+            comm_->irecv(proc, importLocations[proc], requests, proc);
+        }
+
+        if (!sendCellGroups_[proc].empty())
+        {
+            exportLocations[proc] = {haloExportOffsets_[proc], haloExportSize_};
+            comm_->isend(proc, exportLocations[proc], requests, comm_->rank());
+        }
+    }
+
+    comm_->waitAll(requests);
+
+    haloImportLocations_.assign(comm_->nProcs(), std::make_pair(0, 0));
+    for (int proc = 0; proc < comm_->nProcs(); ++proc)
+        if (!importLocations[proc].empty())
+            haloImportLocations_[proc] = std::make_pair(importLocations[proc][0], importLocations[proc][1]);
+
+    //- Export buffers are double buffered
+    haloWindow_ = std::make_shared<SharedWindow>(*nodeComm_, 2 * haloExportSize_);
+    haloParity_ = 0;
+}
+
+std::vector<int> FiniteVolumeGrid2D::cellOwnership() const
+{
+    std::vector<int> cellOwner(cells_.size(), comm_->rank());
+
+    for (int proc = 0; proc < bufferCellZones_.size(); ++proc)
+        for (const Cell &cell: bufferCellZones_[proc])
+            cellOwner[cell.id()] = proc;
+
+    return cellOwner;
+}
+
 void FiniteVolumeGrid2D::initNodes()
 {
     nodeGroup_.clear();
@@ -622,6 +1250,26 @@ void FiniteVolumeGrid2D::initNodes()
 }
 
 void FiniteVolumeGrid2D::initCells()
+{
+    initFaceLinks();
+
+    //- Initialize diagonal links
+    for (Cell &cell: cells_)
+    {
+        for (const Node &node: cell.nodes())
+            for (const Cell &kCell: node.cells())
+            {
+                if (&cell == &kCell)
+                    continue;
+                else if (!cellsShareFace(cell, kCell))
+                    cell.addDiagonalLink(kCell);
+            }
+    }
+
+    setCellsActive(cells_.begin(), cells_.end());
+}
+
+void FiniteVolumeGrid2D::initFaceLinks()
 {
     for (const Face &face: faces_)
     {
@@ -653,21 +1301,6 @@ void FiniteVolumeGrid2D::initCells()
         else if (!boundaryNodes_.isInGroup(face.rNode()))
             interiorNodes_.add(face.rNode());
     }
-
-    //- Initialize diagonal links
-    for (Cell &cell: cells_)
-    {
-        for (const Node &node: cell.nodes())
-            for (const Cell &kCell: node.cells())
-            {
-                if (&cell == &kCell)
-                    continue;
-                else if (!cellsShareFace(cell, kCell))
-                    cell.addDiagonalLink(kCell);
-            }
-    }
-
-    setCellsActive(cells_.begin(), cells_.end());
 }
 
 void FiniteVolumeGrid2D::initConnectivity()
@@ -680,3 +1313,37 @@ void FiniteVolumeGrid2D::computeBoundingBox()
 {
     bBox_ = BoundingBox(nodes_.data(), nodes_.size());
 }
+
+const Cell *FiniteVolumeGrid2D::walk(const Point2D &pt, const Cell &start) const
+{
+    const Cell *cell = &start;
+
+    //- Cells are convex, so pt is inside a cell if it is not beyond any of its faces
+    for (Label step = 0; step < cells_.size(); ++step)
+    {
+        const Cell *next = nullptr;
+        Scalar maxDist = 0.;
+
+        for (const InteriorLink &nb: cell->neighbours())
+        {
+            Scalar dist = dot(pt - nb.face().centroid(), nb.outwardNorm());
+
+            if (dist > maxDist)
+            {
+                next = &nb.cell();
+                maxDist = dist;
+            }
+        }
+
+        for (const BoundaryLink &bd: cell->boundaries())
+            if (dot(pt - bd.face().centroid(), bd.outwardNorm()) > maxDist)
+                return nullptr;
+
+        if (!next)
+            return cell;
+
+        cell = next;
+    }
+
+    return nullptr;
+}
@@ -13,8 +13,11 @@
 #include "Patch.h"
 #include "BoundingBox.h"
 #include "Communicator.h"
+#include "SharedWindow.h"
 #include "Input.h"
 
+class MeshCache;
+
 class FiniteVolumeGrid2D
 {
 public:
@@ -32,6 +35,9 @@ public:
               const std::vector<Label> &cells,
               const Point2D &origin);
 
+    //- Initialization from a mesh cache, the stored connectivity is used instead of being recomputed
+    void init(const MeshCache &cache);
+
     void reset();
 
     //- Size info
@@ -146,7 +152,7 @@ public:
     { return globalActiveCells_; }
 
     const CellZone &localInactiveCells() const
-    { return localActiveCells_; }
+    { return localInactiveCells_; }
 
     const CellZone &globalInactiveCells() const
     { return globalInactiveCells_; }
@@ -206,6 +212,16 @@ public:
 
     std::vector<Ref<const Node>> findNearestNodes(const Point2D &pt, int nNodes) const;
 
+    //- Locate the cell containing pt by walking across the faces that pt lies beyond, starting from a hint cell. The
+    //- node tree is only searched if there is no hint or the walk leaves the grid. Returns nullptr if no cell contains pt
+    const Cell *findContainingCell(const Point2D &pt, const Cell *hint = nullptr) const;
+
+    //- Batched location, each walk starts from the result of the previous query
+    std::vector<const Cell *> findContainingCells(const std::vector<Point2D> &pts, const Cell *hint = nullptr) const;
+
+    //- The vertex nearest to pt of the cell containing it, located from a hint cell
+    const Node &findNearestNode(const Point2D &pt, const Cell *hint) const;
+
     //- Parallel/paritioning
     const Communicator &comm() const
     { return *comm_; }
@@ -214,12 +230,65 @@ public:
 
     void partition(const Input &input, std::shared_ptr<Communicator> comm);
 
+    std::vector<int> computePartition(int nPartitions) const;
+
+    void repartition(const Input &input, const std::vector<Scalar> &cellWeights);
+
+    //- Repartitioning migrates cells by their serial ids, so they must be known for all local entities
+    bool canRepartition() const
+    { return !globalCellIds_.empty() && !globalFaceIds_.empty() && !globalNodeIds_.empty(); }
+
+    //- The crs description of the cells retained by a proc (owned cells and their buffers), with the owning
+    //- proc and serial id of each local entity. Patches are ordered by id and given as local node id pairs
+    struct LocalDomain
+    {
+        std::vector<Point2D> nodes;
+        std::vector<Label> cellInds, cellNodeIds, cellProc, globalCellIds, globalNodeIds;
+        std::vector<std::pair<std::string, std::vector<Label>>> patches;
+    };
+
+    LocalDomain localDomain(const std::vector<int> &cellPartition, int proc, Scalar minBufferWidth) const;
+
+    //- Halo exchange transport, selected by System.haloExchange = pointToPoint (default), neighbourhood
+    //- or sharedMemory
+    void initHaloExchange(const Input &input);
+
     template<class T>
     void sendMessages(std::vector<T> &data) const;
 
     template<class T>
     void sendMessages(std::vector<T> &data, Size nSets) const;
 
+    //- Exchange while the threads execute work(i) for i in [0, n). The work must not touch the exchanged data
+    template<class T, class Work>
+    void sendMessages(std::vector<T> &data, Size nSets, Size n, const Work &work) const;
+
+    //- Serial (decomposition independent) ids of the local entities
+    const std::vector<Label> &globalCellIds() const
+    { return globalCellIds_; }
+
+    const std::vector<Label> &globalFaceIds() const
+    { return globalFaceIds_; }
+
+    const std::vector<Label> &globalNodeIds() const
+    { return globalNodeIds_; }
+
+    Size nSerialFaces() const
+    { return nSerialFaces_; }
+
+    //- Move data of the entities of the previous partition onto the current one, after a repartition
+    template<class T>
+    std::vector<T> migrateCellData(const std::vector<T> &data) const
+    { return migrate(data, cellMigration_, nCells()); }
+
+    template<class T>
+    std::vector<T> migrateFaceData(const std::vector<T> &data) const
+    { return migrate(data, faceMigration_, nFaces()); }
+
+    template<class T>
+    std::vector<T> migrateNodeData(const std::vector<T> &data) const
+    { return migrate(data, nodeMigration_, nNodes()); }
+
     //- Active cell ordering, required for lineary algebra!
     void computeGlobalOrdering();
 
@@ -235,10 +304,44 @@ protected:
 
     void initCells();
 
+    void initFaceLinks();
+
     void initConnectivity();
 
     void computeBoundingBox();
 
+    //- Walk from a cell towards pt, returns nullptr if the walk leaves the grid or does not terminate
+    const Cell *walk(const Point2D &pt, const Cell &start) const;
+
+    void initLocalDomain(const Input &input, const std::vector<int> &cellPartition);
+
+    //- Buffer zones and send groups from the owning proc of each local cell
+    void initBuffers(const Input &input, const std::vector<Label> &cellProc);
+
+    std::vector<int> cellOwnership() const;
+
+    void initSharedMemoryHalo();
+
+    template<class T>
+    void neighbourhoodExchange(std::vector<T> &data, Size nSets) const;
+
+    template<class T>
+    void sharedMemoryExchange(std::vector<T> &data, Size nSets) const;
+
+    //- The old local ids of the entities sent to each proc, and the new local ids of those received from each proc
+    struct Migration
+    {
+        std::vector<std::vector<Label>> sendIds, recvIds;
+    };
+
+    //- Rebuild the local domain from the cells sent by their previous owners
+    void migrateLocalDomain(const Input &input,
+                            const std::vector<int> &newOwner,
+                            const std::vector<std::vector<Label>> &sendCells);
+
+    template<class T>
+    std::vector<T> migrate(const std::vector<T> &data, const Migration &migration, Size size) const;
+
     //- Node related data
     std::vector<Node> nodes_;
     NodeGroup interiorNodes_;
@@ -264,6 +367,20 @@ protected:
     std::vector<CellGroup> sendCellGroups_;
     std::vector<CellZone> bufferCellZones_;
 
+    //- Distributed graph communicator for neighbourhood collective halo exchanges (null if not used)
+    std::shared_ptr<Communicator> neighbourComm_;
+    std::vector<int> neighbourSources_, neighbourDestinations_;
+
+    //- Shared memory halo exchange with ranks on this node (null if not used). Node ranks are -1 for off node procs
+    static const Size haloSlotSize_ = sizeof(Tensor2D);
+    std::shared_ptr<Communicator> nodeComm_;
+    std::shared_ptr<SharedWindow> haloWindow_;
+    std::vector<int> nodeRanks_;
+    std::vector<Size> haloExportOffsets_;
+    std::vector<std::pair<Size, Size>> haloImportLocations_;
+    Size haloExportSize_ = 0;
+    mutable Size haloParity_ = 0;
+
     //- Face related data
     std::vector<Face> faces_;
     std::map<std::pair<Label, Label>, Label> faceDirectory_; // A directory that can find a face given the two node ids
@@ -281,6 +398,14 @@ protected:
 
     //- For node searches
     Group<Node> nodeGroup_;
+
+    Size nSerialFaces_ = 0;
+
+    //- Migration of data from the previous partition
+    Migration cellMigration_, faceMigration_, nodeMigration_;
+
+    //- Local to serial id maps
+    std::vector<Label> globalCellIds_, globalFaceIds_, globalNodeIds_;
 };
 
 #include "FiniteVolumeGrid2D.tpp"
@@ -3,38 +3,68 @@
 template<class T>
 void FiniteVolumeGrid2D::sendMessages(std::vector<T> &data) const
 {
-    if(!comm_ || comm_->nProcs() == 1)
+    sendMessages(data, 1);
+}
+
+template<class T>
+void FiniteVolumeGrid2D::sendMessages(std::vector<T> &data, Size nSets) const
+{
+    sendMessages(data, nSets, 0, [](Size) {});
+}
+
+template<class T, class Work>
+void FiniteVolumeGrid2D::sendMessages(std::vector<T> &data, Size nSets, Size n, const Work &work) const
+{
+    //- Only the point to point messages are progressed during the work
+    if(!comm_ || comm_->nProcs() == 1 || neighbourComm_)
+    {
+        if(neighbourComm_)
+            neighbourhoodExchange(data, nSets);
+
+        for(Size i = 0; i < n; ++i)
+            work(i);
+
         return;
+    }
+
+    //- Neighbours on this node are exchanged through shared memory if the data fits in the halo slots
+    bool shared = haloWindow_ && sizeof(T) * nSets <= haloSlotSize_;
 
     std::vector<std::vector<T>> recvBuffers(comm_->nProcs());
+    Communicator::Requests requests;
 
     //- Post recvs first (non-blocking)
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
     {
-        if(bufferCellZones_[proc].empty())
+        if(bufferCellZones_[proc].empty() || (shared && nodeRanks_[proc] != -1))
             continue;
 
-        recvBuffers[proc].resize(bufferCellZones_[proc].size());
-        comm_->irecv(proc, recvBuffers[proc], proc);
+        recvBuffers[proc].resize(bufferCellZones_[proc].size() * nSets);
+        comm_->irecv(proc, recvBuffers[proc], requests, proc);
     }
 
-    //- Send data (blocking sends)
-    std::vector<T> sendBuffer;
+    //- Send data (non-blocking, buffers must persist until the exchange completes)
+    std::vector<std::vector<T>> sendBuffers(comm_->nProcs());
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
     {
-        if(sendCellGroups_[proc].empty())
+        if(sendCellGroups_[proc].empty() || (shared && nodeRanks_[proc] != -1))
             continue;
 
-        sendBuffer.resize(sendCellGroups_[proc].size());
+        sendBuffers[proc].resize(sendCellGroups_[proc].size() * nSets);
 
-        std::transform(sendCellGroups_[proc].begin(),
-                       sendCellGroups_[proc].end(),
-                       sendBuffer.begin(),
-                       [&data](const Cell& cell) { return data[cell.id()]; });
+        Size i = 0;
+        for(Size set = 0; set < nSets; ++set)
+            for(const Cell& cell: sendCellGroups_[proc])
+                sendBuffers[proc][i++] = data[cell.id() + set * nCells()];
 
-        comm_->ssend(proc, sendBuffer, comm_->rank());
+        comm_->isend(proc, sendBuffers[proc], requests, comm_->rank());
     }
-    comm_->waitAll();
+
+    //- On node exchange overlaps the messages
+    if(shared)
+        sharedMemoryExchange(data, nSets);
+
+    comm_->overlap(requests, n, work);
 
     //- Unload recv buffers
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
@@ -42,57 +72,123 @@ void FiniteVolumeGrid2D::sendMessages(std::vector<T> &data) const
         if(recvBuffers[proc].empty())
             continue;
 
-        int i = 0;
-        for(const Cell& cell: bufferCellZones_[proc])
-            data[cell.id()] = recvBuffers[proc][i++];
+        Size i = 0;
+        for(Size set = 0; set < nSets; ++set)
+            for(const Cell& cell: bufferCellZones_[proc])
+                data[cell.id() + set * nCells()] = recvBuffers[proc][i++];
     }
 }
 
 template<class T>
-void FiniteVolumeGrid2D::sendMessages(std::vector<T> &data, Size nSets) const
+void FiniteVolumeGrid2D::neighbourhoodExchange(std::vector<T> &data, Size nSets) const
 {
-    if(!comm_ || comm_->nProcs() == 1)
-        return;
+    std::vector<int> sendCounts, sendDispls(1, 0), recvCounts, recvDispls(1, 0);
+    std::vector<T> sendBuffer, recvBuffer;
 
-    std::vector<std::vector<T>> recvBuffers(comm_->nProcs());
+    for(int proc: neighbourDestinations_)
+    {
+        for(Size set = 0; set < nSets; ++set)
+            for(const Cell& cell: sendCellGroups_[proc])
+                sendBuffer.push_back(data[cell.id() + set * nCells()]);
+
+        sendCounts.push_back(sendCellGroups_[proc].size() * nSets);
+        sendDispls.push_back(sendDispls.back() + sendCounts.back());
+    }
+
+    for(int proc: neighbourSources_)
+    {
+        recvCounts.push_back(bufferCellZones_[proc].size() * nSets);
+        recvDispls.push_back(recvDispls.back() + recvCounts.back());
+    }
+
+    recvBuffer.resize(recvDispls.back());
+
+    Communicator::Requests requests;
+    neighbourComm_->ineighbourAllToAllv(sendBuffer, sendCounts, sendDispls, recvBuffer, recvCounts, recvDispls, requests);
+    neighbourComm_->waitAll(requests);
+
+    //- Unload recv buffer
+    auto recv = recvBuffer.begin();
+    for(int proc: neighbourSources_)
+        for(Size set = 0; set < nSets; ++set)
+            for(const Cell& cell: bufferCellZones_[proc])
+                data[cell.id() + set * nCells()] = *recv++;
+}
+
+template<class T>
+void FiniteVolumeGrid2D::sharedMemoryExchange(std::vector<T> &data, Size nSets) const
+{
+    //- Export buffers alternate between exchanges, so an owner never overwrites values that may still be read
+    Size parity = haloParity_++ % 2;
 
-    //- Post recvs first (non-blocking)
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
     {
-        if(bufferCellZones_[proc].empty())
+        if(sendCellGroups_[proc].empty() || nodeRanks_[proc] == -1)
             continue;
 
-        recvBuffers[proc].resize(bufferCellZones_[proc].size() * nSets);
-        comm_->irecv(proc, recvBuffers[proc], proc);
+        T *exportBuffer = reinterpret_cast<T*>(haloWindow_->data() + parity * haloExportSize_ + haloExportOffsets_[proc]);
+
+        for(Size set = 0; set < nSets; ++set)
+            for(const Cell& cell: sendCellGroups_[proc])
+                *exportBuffer++ = data[cell.id() + set * nCells()];
     }
 
-    //- Send data (blocking sends)
-    std::vector<T> sendBuffer;
+    haloWindow_->sync();
+
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
     {
-        if(sendCellGroups_[proc].empty())
+        if(bufferCellZones_[proc].empty() || nodeRanks_[proc] == -1)
             continue;
 
-        sendBuffer.resize(sendCellGroups_[proc].size() * nSets);
+        const T *importBuffer = reinterpret_cast<const T*>(haloWindow_->data(nodeRanks_[proc])
+                                                            + parity * haloImportLocations_[proc].second
+                                                            + haloImportLocations_[proc].first);
 
-        Size i = 0;
         for(Size set = 0; set < nSets; ++set)
-            for(const Cell& cell: sendCellGroups_[proc])
-                sendBuffer[i++] = data[cell.id() + set * nCells()];
+            for(const Cell& cell: bufferCellZones_[proc])
+                data[cell.id() + set * nCells()] = *importBuffer++;
+    }
+}
+
+template<class T>
+std::vector<T> FiniteVolumeGrid2D::migrate(const std::vector<T> &data, const Migration &migration, Size size) const
+{
+    if(!comm_ || comm_->nProcs() == 1)
+        return data;
+
+    std::vector<std::vector<T>> sendBuffers(comm_->nProcs()), recvBuffers(comm_->nProcs());
+    Communicator::Requests requests;
+
+    for(int proc = 0; proc < comm_->nProcs(); ++proc)
+    {
+        if(migration.recvIds[proc].empty())
+            continue;
 
-        comm_->ssend(proc, sendBuffer, comm_->rank());
+        recvBuffers[proc].resize(migration.recvIds[proc].size());
+        comm_->irecv(proc, recvBuffers[proc], requests, proc);
     }
-    comm_->waitAll();
 
-    //- Unload recv buffers
     for(int proc = 0; proc < comm_->nProcs(); ++proc)
     {
-        if(recvBuffers[proc].empty())
+        if(migration.sendIds[proc].empty())
             continue;
 
-        int i = 0;
-        for(Size set = 0; set < nSets; ++set)
-            for(const Cell& cell: bufferCellZones_[proc])
-                data[cell.id() + set * nCells()] = recvBuffers[proc][i++];
+        sendBuffers[proc].reserve(migration.sendIds[proc].size());
+
+        for(Label id: migration.sendIds[proc])
+            sendBuffers[proc].push_back(data[id]);
+
+        comm_->isend(proc, sendBuffers[proc], requests, comm_->rank());
     }
+
+    comm_->waitAll(requests);
+
+    //- Entities received from more than one proc have the same value on each
+    std::vector<T> result(size);
+
+    for(int proc = 0; proc < comm_->nProcs(); ++proc)
+        for(Label i = 0; i < recvBuffers[proc].size(); ++i)
+            result[migration.recvIds[proc][i]] = recvBuffers[proc][i];
+
+    return result;
 }
@@ -0,0 +1,309 @@
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "MeshCache.h"
+#include "FiniteVolumeGrid2D.h"
+#include "Exception.h"
+
+namespace
+{
+    const char magic[16] = "PhaseMeshCache";
+
+    //- All entries are 8 byte aligned so that arrays can be used directly from the mapping
+    void writeWord(std::ostream &os, unsigned long word)
+    {
+        os.write(reinterpret_cast<const char *>(&word), sizeof(unsigned long));
+    }
+
+    template<class T>
+    void writeArray(std::ostream &os, const std::vector<T> &vals)
+    {
+        writeWord(os, vals.size());
+        os.write(reinterpret_cast<const char *>(vals.data()), sizeof(T) * vals.size());
+    }
+
+    void writeName(std::ostream &os, const std::string &name)
+    {
+        writeWord(os, name.size());
+        os.write(name.data(), name.size());
+
+        for (Size i = name.size(); i % sizeof(unsigned long) != 0; ++i)
+            os.put('\0');
+    }
+
+    //- Bounds checked reads from the mapping, a null result marks the cache as corrupt
+    class Cursor
+    {
+    public:
+
+        Cursor(const char *begin, const char *end) : pos_(begin), end_(end)
+        {}
+
+        const char *take(Size size)
+        {
+            size = (size + sizeof(unsigned long) - 1) / sizeof(unsigned long) * sizeof(unsigned long);
+
+            if (!pos_ || size > end_ - pos_)
+                return pos_ = nullptr;
+
+            const char *data = pos_;
+            pos_ += size;
+
+            return data;
+        }
+
+        bool word(unsigned long &word)
+        {
+            const char *data = take(sizeof(unsigned long));
+
+            if (data)
+                std::memcpy(&word, data, sizeof(unsigned long));
+
+            return data != nullptr;
+        }
+
+        template<class T>
+        bool array(MeshCache::Array<T> &array)
+        {
+            unsigned long size;
+
+            if (!word(size) || size > (end_ - pos_) / sizeof(T))
+                return false;
+
+            array = MeshCache::Array<T>(reinterpret_cast<const T *>(take(size * sizeof(T))), size);
+
+            return true;
+        }
+
+        bool atEnd() const
+        { return pos_ == end_; }
+
+    private:
+
+        const char *pos_, *end_;
+    };
+}
+
+const Label MeshCache::none = std::numeric_limits<Label>::max();
+
+MeshCache::MeshCache(const std::string &filename, unsigned long sourceHash)
+        :
+        data_(nullptr),
+        size_(0)
+{
+    map(filename, sourceHash);
+}
+
+MeshCache::~MeshCache()
+{
+    unmap();
+}
+
+void MeshCache::write(const std::string &filename, unsigned long sourceHash, const FiniteVolumeGrid2D &grid)
+{
+    std::vector<Scalar> nodes;
+    nodes.reserve(2 * grid.nNodes());
+
+    for (const Node &node: grid.nodes())
+    {
+        nodes.push_back(node.x);
+        nodes.push_back(node.y);
+    }
+
+    std::pair<std::vector<int>, std::vector<int>> cells = grid.nodeElementConnectivity();
+    std::vector<Label> faceNodeIds, faceCellIds, sortedFaceIds(grid.nFaces());
+
+    faceNodeIds.reserve(2 * grid.nFaces());
+    faceCellIds.reserve(2 * grid.nFaces());
+
+    for (const Face &face: grid.faces())
+    {
+        faceNodeIds.push_back(face.lNode().id());
+        faceNodeIds.push_back(face.rNode().id());
+        faceCellIds.push_back(face.lCell().id());
+        faceCellIds.push_back(face.isInterior() ? face.rCell().id() : none);
+    }
+
+    auto key = [&faceNodeIds](Label id) {
+        Label n1 = faceNodeIds[2 * id], n2 = faceNodeIds[2 * id + 1];
+        return n1 < n2 ? std::make_pair(n1, n2) : std::make_pair(n2, n1);
+    };
+
+    std::iota(sortedFaceIds.begin(), sortedFaceIds.end(), 0);
+    std::sort(sortedFaceIds.begin(), sortedFaceIds.end(), [&key](Label lhs, Label rhs) { return key(lhs) < key(rhs); });
+
+    std::vector<Label> diagonalInds(1, 0), diagonalCellIds;
+
+    for (const Cell &cell: grid.cells())
+    {
+        for (const CellLink &dg: cell.diagonals())
+            diagonalCellIds.push_back(dg.cell().id());
+
+        diagonalInds.push_back(diagonalCellIds.size());
+    }
+
+    std::vector<Ref<const Patch>> patches = grid.patches();
+    std::sort(patches.begin(), patches.end(), [](const Patch &lhs, const Patch &rhs) { return lhs.id() < rhs.id(); });
+
+    const std::string tmpFilename = filename + ".tmp";
+    std::ofstream fout(tmpFilename.c_str(), std::ios::binary);
+
+    fout.write(magic, sizeof(magic));
+    writeWord(fout, version_);
+    writeWord(fout, sizeof(Label));
+    writeWord(fout, sourceHash);
+
+    writeArray(fout, nodes);
+    writeArray(fout, std::vector<Label>(cells.first.begin(), cells.first.end()));
+    writeArray(fout, std::vector<Label>(cells.second.begin(), cells.second.end()));
+    writeArray(fout, faceNodeIds);
+    writeArray(fout, faceCellIds);
+    writeArray(fout, sortedFaceIds);
+    writeArray(fout, diagonalInds);
+    writeArray(fout, diagonalCellIds);
+
+    writeWord(fout, patches.size());
+
+    for (const Patch &patch: patches)
+    {
+        std::vector<Label> faceIds;
+        faceIds.reserve(patch.size());
+
+        for (const Face &face: patch)
+            faceIds.push_back(face.id());
+
+        writeName(fout, patch.name());
+        writeArray(fout, faceIds);
+    }
+
+    fout.close();
+
+    if (!fout || std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(tmpFilename.c_str());
+        throw Exception("MeshCache", "write", "could not write mesh cache \"" + filename + "\".");
+    }
+}
+
+unsigned long MeshCache::hashFile(const std::string &filename, unsigned long hash)
+{
+    std::ifstream fin(filename.c_str(), std::ios::binary);
+
+    if (!fin)
+        throw Exception("MeshCache", "hashFile", "could not open file \"" + filename + "\".");
+
+    std::vector<char> buffer(1 << 20);
+
+    while (fin.read(buffer.data(), buffer.size()) || fin.gcount() > 0)
+        hash = MeshCache::hash(buffer.data(), fin.gcount(), hash);
+
+    return hash;
+}
+
+unsigned long MeshCache::hash(const void *data, Size size, unsigned long hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+    for (Size i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ul;
+    }
+
+    return hash;
+}
+
+//- Private methods
+
+void MeshCache::map(const std::string &filename, unsigned long sourceHash)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd == -1)
+        return;
+
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED)
+        {
+            data_ = data;
+            size_ = st.st_size;
+        }
+    }
+
+    close(fd);
+
+    if (!data_)
+        return;
+
+    const char *begin = static_cast<const char *>(data_);
+    Cursor cursor(begin, begin + size_);
+
+    const char *header = cursor.take(sizeof(magic));
+    unsigned long version, labelSize, hash, nPatches;
+
+    bool ok = header && std::memcmp(header, magic, sizeof(magic)) == 0
+              && cursor.word(version) && version == version_
+              && cursor.word(labelSize) && labelSize == sizeof(Label)
+              && cursor.word(hash) && hash == sourceHash
+              && cursor.array(nodes_)
+              && cursor.array(cellInds_)
+              && cursor.array(cellNodeIds_)
+              && cursor.array(faceNodeIds_)
+              && cursor.array(faceCellIds_)
+              && cursor.array(sortedFaceIds_)
+              && cursor.array(diagonalInds_)
+              && cursor.array(diagonalCellIds_)
+              && cursor.word(nPatches);
+
+    for (unsigned long i = 0; ok && i < nPatches; ++i)
+    {
+        unsigned long nameSize;
+        const char *name;
+        PatchData patch;
+
+        ok = cursor.word(nameSize) && (name = cursor.take(nameSize)) && cursor.array(patch.faceIds);
+
+        if (ok)
+        {
+            patch.name.assign(name, nameSize);
+            patches_.push_back(patch);
+        }
+    }
+
+    //- Check that the arrays are consistent
+    ok = ok && cursor.atEnd()
+         && cellInds_.size() > 0 && diagonalInds_.size() == cellInds_.size()
+         && faceCellIds_.size() == faceNodeIds_.size() && 2 * sortedFaceIds_.size() == faceNodeIds_.size()
+         && cellInds_[cellInds_.size() - 1] == cellNodeIds_.size()
+         && diagonalInds_[diagonalInds_.size() - 1] == diagonalCellIds_.size();
+
+    if (!ok)
+        unmap();
+}
+
+void MeshCache::unmap()
+{
+    if (data_)
+        munmap(data_, size_);
+
+    data_ = nullptr;
+    size_ = 0;
+    nodes_ = Array<Scalar>();
+    cellInds_ = cellNodeIds_ = faceNodeIds_ = faceCellIds_ = sortedFaceIds_ = Array<Label>();
+    diagonalInds_ = diagonalCellIds_ = Array<Label>();
+    patches_.clear();
+}
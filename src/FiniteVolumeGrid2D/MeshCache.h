@@ -0,0 +1,124 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include "Types.h"
+
+class FiniteVolumeGrid2D;
+
+//- A native binary copy of a serial grid with its precomputed connectivity (faces, face directory, diagonal
+//- links and patches). The file is memory mapped and the arrays are used in place, it is only valid for the
+//- source mesh whose hash it was written with
+class MeshCache
+{
+public:
+
+    //- A view of an array in the mapped file
+    template<class T>
+    class Array
+    {
+    public:
+
+        Array() : data_(nullptr), size_(0)
+        {}
+
+        Array(const T *data, Size size) : data_(data), size_(size)
+        {}
+
+        Size size() const
+        { return size_; }
+
+        const T &operator[](Size i) const
+        { return data_[i]; }
+
+        const T *begin() const
+        { return data_; }
+
+        const T *end() const
+        { return data_ + size_; }
+
+    private:
+
+        const T *data_;
+        Size size_;
+    };
+
+    struct PatchData
+    {
+        std::string name;
+        Array<Label> faceIds;
+    };
+
+    static const Label none;
+
+    //- Map a cache file. The cache is invalid if it does not exist, is corrupt or was written for another source
+    MeshCache(const std::string &filename, unsigned long sourceHash);
+
+    MeshCache(const MeshCache &other) = delete;
+
+    ~MeshCache();
+
+    bool valid() const
+    { return data_ != nullptr; }
+
+    //- Write the cache of a serial grid. A temporary file is renamed so that a cache is never read partially written
+    static void write(const std::string &filename, unsigned long sourceHash, const FiniteVolumeGrid2D &grid);
+
+    //- FNV-1a hash of a file's contents
+    static unsigned long hashFile(const std::string &filename, unsigned long hash = 14695981039346656037ul);
+
+    //- FNV-1a hash of raw bytes
+    static unsigned long hash(const void *data, Size size, unsigned long hash = 14695981039346656037ul);
+
+    //- Node coordinates as x,y pairs
+    const Array<Scalar> &nodes() const
+    { return nodes_; }
+
+    //- Cell node ids in crs format
+    const Array<Label> &cellInds() const
+    { return cellInds_; }
+
+    const Array<Label> &cellNodeIds() const
+    { return cellNodeIds_; }
+
+    //- Face node and cell id pairs in the order faces are created, the second cell of boundary faces is none
+    const Array<Label> &faceNodeIds() const
+    { return faceNodeIds_; }
+
+    const Array<Label> &faceCellIds() const
+    { return faceCellIds_; }
+
+    //- Face ids sorted by their node pairs, so that the face directory can be built without searches
+    const Array<Label> &sortedFaceIds() const
+    { return sortedFaceIds_; }
+
+    //- Diagonal cell ids in crs format
+    const Array<Label> &diagonalInds() const
+    { return diagonalInds_; }
+
+    const Array<Label> &diagonalCellIds() const
+    { return diagonalCellIds_; }
+
+    //- Patches, in order of their ids
+    const std::vector<PatchData> &patches() const
+    { return patches_; }
+
+private:
+
+    static const int version_ = 1;
+
+    void map(const std::string &filename, unsigned long sourceHash);
+
+    void unmap();
+
+    void *data_;
+    Size size_;
+
+    Array<Scalar> nodes_;
+    Array<Label> cellInds_, cellNodeIds_, faceNodeIds_, faceCellIds_, sortedFaceIds_, diagonalInds_, diagonalCellIds_;
+    std::vector<PatchData> patches_;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef BATCHED_MATRIX_H
+#define BATCHED_MATRIX_H
+
+#include <vector>
+
+#include "StaticMatrix.h"
+
+//- A batch of small dense MxN matrices stored component major, so that entry (i, j) of every matrix is contiguous.
+//- The kernels loop over the batch innermost and are branch free, so that they vectorize without calls to LAPACK
+template<int M, int N>
+class BatchedMatrix
+{
+public:
+
+    BatchedMatrix(Size size = 0) : size_(size), vals_(M * N * size, 0.)
+    {}
+
+    Size size() const
+    { return size_; }
+
+    void resize(Size size);
+
+    Scalar &operator()(Size k, int i, int j)
+    { return vals_[(i * N + j) * size_ + k]; }
+
+    Scalar operator()(Size k, int i, int j) const
+    { return vals_[(i * N + j) * size_ + k]; }
+
+    void set(Size k, const StaticMatrix<M, N> &A);
+
+    StaticMatrix<M, N> get(Size k) const;
+
+    //- Invert all matrices by Gauss-Jordan elimination with partial pivoting
+    BatchedMatrix<M, N> &invert();
+
+private:
+
+    //- Entry (i, j) of all matrices
+    Scalar *entries(int i, int j)
+    { return vals_.data() + (i * N + j) * size_; }
+
+    const Scalar *entries(int i, int j) const
+    { return vals_.data() + (i * N + j) * size_; }
+
+    Size size_;
+    std::vector<Scalar> vals_;
+};
+
+template<int M, int N>
+BatchedMatrix<M, N> inverse(BatchedMatrix<M, N> A)
+{
+    A.invert();
+    return A;
+}
+
+//- Least-squares pseudo inverses (A^T A)^-1 A^T of full column rank matrices, from Householder QR factorizations.
+//- The normal equations are not formed, so the conditioning of polynomial fits is not squared
+template<int M, int N>
+BatchedMatrix<N, M> pseudoInverse(const BatchedMatrix<M, N> &A);
+
+#include "BatchedMatrix.tpp"
+
+#endif
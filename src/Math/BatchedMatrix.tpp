@@ -0,0 +1,249 @@
+#include <cmath>
+
+#include "BatchedMatrix.h"
+
+template<int M, int N>
+void BatchedMatrix<M, N>::resize(Size size)
+{
+    size_ = size;
+    vals_.assign(M * N * size, 0.);
+}
+
+template<int M, int N>
+void BatchedMatrix<M, N>::set(Size k, const StaticMatrix<M, N> &A)
+{
+    for (int i = 0; i < M; ++i)
+        for (int j = 0; j < N; ++j)
+            entries(i, j)[k] = A(i, j);
+}
+
+template<int M, int N>
+StaticMatrix<M, N> BatchedMatrix<M, N>::get(Size k) const
+{
+    StaticMatrix<M, N> A;
+
+    for (int i = 0; i < M; ++i)
+        for (int j = 0; j < N; ++j)
+            A(i, j) = entries(i, j)[k];
+
+    return A;
+}
+
+template<int M, int N>
+BatchedMatrix<M, N> &BatchedMatrix<M, N>::invert()
+{
+    static_assert(M == N, "Matrix must be square.");
+
+    const Size n = size_;
+    std::vector<int> pivotRows(N * n), pivotRow(n);
+    std::vector<Scalar> pivot(n);
+
+    for (int k = 0; k < N; ++k)
+    {
+        //- Each matrix selects its own pivot row
+        const Scalar *akk = entries(k, k);
+
+        for (Size b = 0; b < n; ++b)
+        {
+            pivot[b] = std::abs(akk[b]);
+            pivotRow[b] = k;
+        }
+
+        for (int i = k + 1; i < N; ++i)
+        {
+            const Scalar *aik = entries(i, k);
+
+            for (Size b = 0; b < n; ++b)
+            {
+                bool larger = std::abs(aik[b]) > pivot[b];
+                pivot[b] = larger ? std::abs(aik[b]) : pivot[b];
+                pivotRow[b] = larger ? i : pivotRow[b];
+            }
+        }
+
+        int singular = 0;
+
+        for (Size b = 0; b < n; ++b)
+            singular |= pivot[b] == 0.;
+
+        if (singular)
+            throw Exception("BatchedMatrix", "invert", "inversion failed, matrix is singular to working precision.");
+
+        //- Row interchanges are blended, so that they do not branch on the pivot row
+        for (int i = k + 1; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+            {
+                Scalar *akj = entries(k, j), *aij = entries(i, j);
+
+                for (Size b = 0; b < n; ++b)
+                {
+                    bool swap = pivotRow[b] == i;
+                    Scalar tmp = akj[b];
+                    akj[b] = swap ? aij[b] : tmp;
+                    aij[b] = swap ? tmp : aij[b];
+                }
+            }
+
+        std::copy(pivotRow.begin(), pivotRow.end(), pivotRows.begin() + k * n);
+
+        //- Eliminate column k from all other rows, the inverse is accumulated in place
+        Scalar *pkk = entries(k, k);
+
+        for (Size b = 0; b < n; ++b)
+        {
+            pivot[b] = 1. / pkk[b];
+            pkk[b] = 1.;
+        }
+
+        for (int j = 0; j < N; ++j)
+        {
+            Scalar *akj = entries(k, j);
+
+            for (Size b = 0; b < n; ++b)
+                akj[b] *= pivot[b];
+        }
+
+        for (int i = 0; i < N; ++i)
+        {
+            if (i == k)
+                continue;
+
+            Scalar *aik = entries(i, k);
+
+            for (Size b = 0; b < n; ++b)
+            {
+                pivot[b] = aik[b];
+                aik[b] = 0.;
+            }
+
+            for (int j = 0; j < N; ++j)
+            {
+                Scalar *aij = entries(i, j);
+                const Scalar *akj = entries(k, j);
+
+                for (Size b = 0; b < n; ++b)
+                    aij[b] -= pivot[b] * akj[b];
+            }
+        }
+    }
+
+    //- The row interchanges of the factorization are undone as column interchanges, in reverse order
+    for (int k = N - 1; k >= 0; --k)
+    {
+        const int *rows = pivotRows.data() + k * n;
+
+        for (int j = k + 1; j < N; ++j)
+            for (int i = 0; i < N; ++i)
+            {
+                Scalar *aik = entries(i, k), *aij = entries(i, j);
+
+                for (Size b = 0; b < n; ++b)
+                {
+                    bool swap = rows[b] == j;
+                    Scalar tmp = aik[b];
+                    aik[b] = swap ? aij[b] : tmp;
+                    aij[b] = swap ? tmp : aij[b];
+                }
+            }
+    }
+
+    return *this;
+}
+
+template<int M, int N>
+BatchedMatrix<N, M> pseudoInverse(const BatchedMatrix<M, N> &A)
+{
+    static_assert(M >= N, "Matrix must have at least as many rows as columns.");
+
+    const Size n = A.size();
+
+    //- Householder QR, R overwrites a copy of A and Q^T is accumulated from the identity
+    BatchedMatrix<M, N> R = A;
+    BatchedMatrix<M, M> Qt(n);
+    BatchedMatrix<M, 1> v(n);
+    std::vector<Scalar> beta(n), dot(n);
+
+    for (int i = 0; i < M; ++i)
+        for (Size b = 0; b < n; ++b)
+            Qt(b, i, i) = 1.;
+
+    for (int k = 0; k < N; ++k)
+    {
+        //- Reflector v = x - alpha e_k of column k below the diagonal, with the sign of alpha chosen to avoid
+        //  cancellation. Zero columns use the identity
+        for (Size b = 0; b < n; ++b)
+            dot[b] = 0.;
+
+        for (int i = k; i < M; ++i)
+            for (Size b = 0; b < n; ++b)
+            {
+                v(b, i, 0) = R(b, i, k);
+                dot[b] += R(b, i, k) * R(b, i, k);
+            }
+
+        for (Size b = 0; b < n; ++b)
+        {
+            Scalar alpha = R(b, k, k) < 0. ? std::sqrt(dot[b]) : -std::sqrt(dot[b]);
+            v(b, k, 0) -= alpha;
+            dot[b] += v(b, k, 0) * v(b, k, 0) - R(b, k, k) * R(b, k, k);
+            beta[b] = dot[b] > 0. ? 2. / dot[b] : 0.;
+        }
+
+        //- Apply I - beta v v^T to the remaining columns of R and to Q^T
+        for (int j = k; j < N; ++j)
+        {
+            for (Size b = 0; b < n; ++b)
+                dot[b] = 0.;
+
+            for (int i = k; i < M; ++i)
+                for (Size b = 0; b < n; ++b)
+                    dot[b] += v(b, i, 0) * R(b, i, j);
+
+            for (int i = k; i < M; ++i)
+                for (Size b = 0; b < n; ++b)
+                    R(b, i, j) -= beta[b] * dot[b] * v(b, i, 0);
+        }
+
+        for (int j = 0; j < M; ++j)
+        {
+            for (Size b = 0; b < n; ++b)
+                dot[b] = 0.;
+
+            for (int i = k; i < M; ++i)
+                for (Size b = 0; b < n; ++b)
+                    dot[b] += v(b, i, 0) * Qt(b, i, j);
+
+            for (int i = k; i < M; ++i)
+                for (Size b = 0; b < n; ++b)
+                    Qt(b, i, j) -= beta[b] * dot[b] * v(b, i, 0);
+        }
+    }
+
+    int singular = 0;
+
+    for (int k = 0; k < N; ++k)
+        for (Size b = 0; b < n; ++b)
+            singular |= R(b, k, k) == 0.;
+
+    if (singular)
+        throw Exception("BatchedMatrix", "pseudoInverse", "matrix is rank deficient to working precision.");
+
+    //- Back substitution R1 X = (Q^T)_1, for the leading N rows
+    BatchedMatrix<N, M> pInv(n);
+
+    for (int i = N - 1; i >= 0; --i)
+        for (int c = 0; c < M; ++c)
+        {
+            for (Size b = 0; b < n; ++b)
+                pInv(b, i, c) = Qt(b, i, c);
+
+            for (int j = i + 1; j < N; ++j)
+                for (Size b = 0; b < n; ++b)
+                    pInv(b, i, c) -= R(b, i, j) * pInv(b, j, c);
+
+            for (Size b = 0; b < n; ++b)
+                pInv(b, i, c) /= R(b, i, i);
+        }
+
+    return pInv;
+}
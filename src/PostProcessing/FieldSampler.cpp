@@ -0,0 +1,339 @@
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+
+#include "FieldSampler.h"
+#include "BilinearInterpolation.h"
+
+FieldSampler::FieldSampler(const Solver &solver,
+                           const std::string &name,
+                           const std::vector<std::string> &fieldNames,
+                           const std::string &type)
+        :
+        PostProcessingObject(solver),
+        name_(name)
+{
+    outputDir_ = outputDir_ / type / name;
+
+    for (const std::string &fieldName: fieldNames)
+    {
+        if (solver.scalarFields().find(fieldName) != solver.scalarFields().end())
+            scalarFields_.push_back(std::cref(solver.scalarField(fieldName)));
+        else if (solver.vectorFields().find(fieldName) != solver.vectorFields().end())
+            vectorFields_.push_back(std::cref(solver.vectorField(fieldName)));
+        else
+            throw Exception("FieldSampler", "FieldSampler", "no scalar or vector field \"" + fieldName + "\".");
+    }
+
+    buffers_.resize(scalarFields_.size() + vectorFields_.size());
+}
+
+FieldSampler::~FieldSampler()
+{
+    flush();
+}
+
+void FieldSampler::compute(Scalar time)
+{
+    if (iterNo_++ % fileWriteFrequency_ != 0)
+        return;
+
+    const Communicator &comm = solver_.grid().comm();
+    int bufferNo = 0;
+
+    auto row = [this, time](const std::vector<std::string> &vals) {
+        std::ostringstream sout;
+        sout << std::setprecision(std::numeric_limits<Scalar>::digits10) << time;
+
+        for (const std::string &val: vals)
+            sout << "\t" << val;
+
+        sout << "\n";
+        return sout.str();
+    };
+
+    for (const ScalarFiniteVolumeField &field: scalarFields_)
+    {
+        std::vector<Scalar> vals(samples_.size(), 0.);
+
+        for (Label i = 0; i < samples_.size(); ++i)
+            for (Label j = 0; j < samples_[i].cellIds.size(); ++j)
+                vals[i] += samples_[i].weights[j] * field[samples_[i].cellIds[j]];
+
+        vals = comm.gatherv(comm.mainProcNo(), vals);
+
+        if (comm.isMainProc())
+        {
+            std::vector<std::string> cols(vals.size());
+
+            for (Label i = 0; i < vals.size(); ++i)
+            {
+                std::ostringstream sout;
+                sout << std::setprecision(std::numeric_limits<Scalar>::digits10) << vals[i];
+                cols[sampleOrder_[i]] = sout.str();
+            }
+
+            buffers_[bufferNo] += row(cols);
+        }
+
+        ++bufferNo;
+    }
+
+    for (const VectorFiniteVolumeField &field: vectorFields_)
+    {
+        std::vector<Vector2D> vals(samples_.size(), Vector2D(0., 0.));
+
+        for (Label i = 0; i < samples_.size(); ++i)
+            for (Label j = 0; j < samples_[i].cellIds.size(); ++j)
+                vals[i] += samples_[i].weights[j] * field[samples_[i].cellIds[j]];
+
+        vals = comm.gatherv(comm.mainProcNo(), vals);
+
+        if (comm.isMainProc())
+        {
+            std::vector<std::string> cols(vals.size());
+
+            for (Label i = 0; i < vals.size(); ++i)
+            {
+                std::ostringstream sout;
+                sout << std::setprecision(std::numeric_limits<Scalar>::digits10) << vals[i].x << "\t" << vals[i].y;
+                cols[sampleOrder_[i]] = sout.str();
+            }
+
+            buffers_[bufferNo] += row(cols);
+        }
+
+        ++bufferNo;
+    }
+
+    if (++nBuffered_ >= bufferSize_)
+        flush();
+}
+
+void FieldSampler::updateGrid()
+{
+    //- Local cell ids are not preserved by a repartition
+    if (points_.empty())
+        locateCells();
+    else
+        locatePoints(false);
+}
+
+//- Protected methods
+
+void FieldSampler::setSamplePoints(const std::vector<Point2D> &points)
+{
+    points_ = points;
+    locatePoints(true);
+}
+
+void FieldSampler::setSampleCells(const std::vector<Ref<const Cell>> &cells)
+{
+    const FiniteVolumeGrid2D &grid = solver_.grid();
+    const Communicator &comm = grid.comm();
+
+    std::vector<int> ids;
+    for (const Cell &cell: cells)
+        ids.push_back(grid.globalCellIds().empty() ? cell.id() : grid.globalCellIds()[cell.id()]);
+
+    ids = comm.allGatherv(ids);
+    cellIds_.assign(ids.begin(), ids.end());
+    std::sort(cellIds_.begin(), cellIds_.end());
+
+    locateCells();
+
+    std::vector<Vector2D> centroids;
+    for (const Sample &sample: samples_)
+        centroids.push_back(grid.cells()[sample.cellIds.front()].centroid());
+
+    centroids = comm.gatherv(comm.mainProcNo(), centroids);
+
+    columnPoints_.resize(centroids.size());
+    for (Label i = 0; i < centroids.size(); ++i)
+        columnPoints_[sampleOrder_[i]] = centroids[i];
+}
+
+void FieldSampler::flush()
+{
+    if (solver_.grid().comm().isMainProc())
+    {
+        if (!headersWritten_)
+            writeHeaders();
+
+        int bufferNo = 0;
+
+        for (const ScalarFiniteVolumeField &field: scalarFields_)
+        {
+            std::ofstream fout(filename(field.name()).string(), std::ofstream::out | std::ofstream::app);
+            fout << buffers_[bufferNo];
+            buffers_[bufferNo++].clear();
+        }
+
+        for (const VectorFiniteVolumeField &field: vectorFields_)
+        {
+            std::ofstream fout(filename(field.name()).string(), std::ofstream::out | std::ofstream::app);
+            fout << buffers_[bufferNo];
+            buffers_[bufferNo++].clear();
+        }
+    }
+
+    nBuffered_ = 0;
+}
+
+//- Private methods
+
+void FieldSampler::locatePoints(bool warn)
+{
+    const FiniteVolumeGrid2D &grid = solver_.grid();
+    const Communicator &comm = grid.comm();
+    const std::vector<Point2D> &points = points_;
+
+    //- Find the points within the cells owned by this proc, active or not, so that ownership does not change when
+    //- cells are deactivated. Successive sample points are usually close, so each point is located by a walk from
+    //- the cell of the previous one
+    std::vector<int> localPoints;
+    std::vector<Label> containingCells;
+    std::vector<const Cell *> cells = grid.findContainingCells(points);
+
+    for (Label i = 0; i < points.size(); ++i)
+        if (cells[i]
+            && (grid.localActiveCells().isInGroup(*cells[i]) || grid.localInactiveCells().isInGroup(*cells[i])))
+        {
+            localPoints.push_back(i);
+            containingCells.push_back(cells[i]->id());
+        }
+
+    //- Points on partition boundaries may be found by more than one proc, the lowest rank owns them
+    std::vector<int> nLocalPoints = comm.allGather((int) localPoints.size());
+    std::vector<int> allPoints = comm.allGatherv(localPoints);
+    std::vector<int> ownerProc(points.size(), -1);
+
+    for (int proc = 0, i = 0; proc < comm.nProcs(); ++proc)
+        for (int end = i + nLocalPoints[proc]; i < end; ++i)
+            if (ownerProc[allPoints[i]] == -1)
+                ownerProc[allPoints[i]] = proc;
+
+    //- Construct the interpolation stencils of the owned points. Degenerate stencils and points in inactive cells
+    //- use the containing cell
+    samples_.clear();
+
+    for (Label i = 0; i < localPoints.size(); ++i)
+    {
+        const Point2D &pt = points[localPoints[i]];
+
+        if (ownerProc[localPoints[i]] != comm.rank())
+            continue;
+
+        Sample sample;
+        std::vector<Point2D> centroids;
+
+        for (const Cell &cell: grid.globalActiveCells().nearestItems(pt, 4))
+        {
+            sample.cellIds.push_back(cell.id());
+            centroids.push_back(cell.centroid());
+        }
+
+        try
+        {
+            if (grid.localInactiveCells().isInGroup(grid.cells()[containingCells[i]]))
+                throw Exception("FieldSampler", "locatePoints", "point is in an inactive cell.");
+
+            if (centroids.size() != 4)
+                throw Exception("FieldSampler", "locatePoints", "insufficient cells for interpolation.");
+
+            sample.weights = BilinearInterpolation(centroids)(pt);
+        }
+        catch (const Exception &)
+        {
+            sample.cellIds.assign(1, containingCells[i]);
+            sample.weights.assign(1, 1.);
+        }
+
+        samples_.push_back(sample);
+    }
+
+    //- Columns are in the order the points were given, points outside the domain are dropped
+    std::vector<Label> column(points.size());
+    columnPoints_.clear();
+
+    for (Label i = 0; i < points.size(); ++i)
+    {
+        if (ownerProc[i] == -1)
+        {
+            if (warn)
+                comm.printf("Warning: sample point %s of \"%s\" is outside of the domain.\n",
+                            points[i].toString().c_str(), name_.c_str());
+            continue;
+        }
+
+        column[i] = columnPoints_.size();
+        columnPoints_.push_back(points[i]);
+    }
+
+    sampleOrder_.clear();
+
+    for (int proc = 0; proc < comm.nProcs(); ++proc)
+        for (Label i = 0; i < points.size(); ++i)
+            if (ownerProc[i] == proc)
+                sampleOrder_.push_back(column[i]);
+}
+
+void FieldSampler::locateCells()
+{
+    const FiniteVolumeGrid2D &grid = solver_.grid();
+    std::vector<int> columns;
+
+    samples_.clear();
+
+    //- Inactive cells are included, so that the columns do not change when cells are deactivated
+    for (const CellZone &zone: {std::cref(grid.localActiveCells()), std::cref(grid.localInactiveCells())})
+        for (const Cell &cell: zone)
+        {
+            Label id = grid.globalCellIds().empty() ? cell.id() : grid.globalCellIds()[cell.id()];
+            auto it = std::lower_bound(cellIds_.begin(), cellIds_.end(), id);
+
+            if (it != cellIds_.end() && *it == id)
+            {
+                samples_.push_back(Sample{std::vector<Label>(1, cell.id()), std::vector<Scalar>(1, 1.)});
+                columns.push_back(it - cellIds_.begin());
+            }
+        }
+
+    columns = grid.comm().allGatherv(columns);
+    sampleOrder_.assign(columns.begin(), columns.end());
+}
+
+void FieldSampler::writeHeaders()
+{
+    createOutputDirectory();
+
+    std::ostringstream header;
+    header << "# Sample points:";
+
+    for (const Point2D &pt: columnPoints_)
+        header << " " << pt;
+
+    header << "\n";
+
+    //- Restarted runs continue the existing files
+    for (const ScalarFiniteVolumeField &field: scalarFields_)
+    {
+        if (append_ && boost::filesystem::exists(filename(field.name())))
+            continue;
+
+        std::ofstream fout(filename(field.name()).string());
+        fout << header.str() << "time\t" << field.name() << "[sample]\n";
+    }
+
+    for (const VectorFiniteVolumeField &field: vectorFields_)
+    {
+        if (append_ && boost::filesystem::exists(filename(field.name())))
+            continue;
+
+        std::ofstream fout(filename(field.name()).string());
+        fout << header.str() << "time\t" << field.name() << "X[sample]\t" << field.name() << "Y[sample]\n";
+    }
+
+    headersWritten_ = true;
+}
@@ -0,0 +1,80 @@
+#ifndef FIELD_SAMPLER_H
+#define FIELD_SAMPLER_H
+
+#include "PostProcessingObject.h"
+
+//- Base for objects that sample fields at a fixed set of locations. Samples are located once (and again after a
+//- repartition), each is owned by a single proc, and only the sampled values are gathered to the main proc. Each
+//- field is written to a time series file with one row per write, buffered in memory for bufferSize writes
+class FieldSampler : public PostProcessingObject
+{
+public:
+
+    FieldSampler(const Solver &solver,
+                 const std::string &name,
+                 const std::vector<std::string> &fieldNames,
+                 const std::string &type);
+
+    ~FieldSampler();
+
+    void compute(Scalar time);
+
+    void updateGrid();
+
+    void setBufferSize(int bufferSize)
+    { bufferSize_ = bufferSize; }
+
+    //- Append to existing output files instead of replacing them, e.g. when restarting
+    void setAppend(bool append)
+    { append_ = append; }
+
+protected:
+
+    //- Samples interpolated from the cells surrounding a point
+    void setSamplePoints(const std::vector<Point2D> &points);
+
+    //- Samples of the values of cells owned by this proc, ordered by serial id
+    void setSampleCells(const std::vector<Ref<const Cell>> &cells);
+
+    void flush();
+
+    std::string name_;
+
+    std::vector<Ref<const ScalarFiniteVolumeField>> scalarFields_;
+    std::vector<Ref<const VectorFiniteVolumeField>> vectorFields_;
+
+private:
+
+    //- Each local sample is a weighted sum of cell values
+    struct Sample
+    {
+        std::vector<Label> cellIds;
+        std::vector<Scalar> weights;
+    };
+
+    //- Construct the local samples of the sample points, or of the sampled cells
+    void locatePoints(bool warn);
+
+    void locateCells();
+
+    void writeHeaders();
+
+    boost::filesystem::path filename(const std::string &fieldName) const
+    { return outputDir_ / (fieldName + ".dat"); }
+
+    //- Sample points, or the sorted serial ids of the sampled cells
+    std::vector<Point2D> points_;
+    std::vector<Label> cellIds_;
+
+    std::vector<Sample> samples_;
+
+    //- Sample order of the gathered values and the locations of the columns (main proc only)
+    std::vector<Label> sampleOrder_;
+    std::vector<Point2D> columnPoints_;
+
+    std::vector<std::string> buffers_;
+    int nBuffered_ = 0, bufferSize_ = 100;
+    bool append_ = false, headersWritten_ = false;
+};
+
+#endif
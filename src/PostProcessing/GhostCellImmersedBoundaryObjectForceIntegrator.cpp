@@ -1,3 +1,6 @@
+#include <iomanip>
+#include <limits>
+
 #include "GhostCellImmersedBoundaryObjectForceIntegrator.h"
 
 GhostCellImmersedBoundaryObjectForceIntegrator::GhostCellImmersedBoundaryObjectForceIntegrator(const Solver &solver)
@@ -17,8 +20,8 @@ GhostCellImmersedBoundaryObjectForceIntegrator::GhostCellImmersedBoundaryObjectF
         {
             if (solver.grid().comm().isMainProc())
             {
-                std::ofstream fout((outputDir_ / (gcIbObj->name() + "_contactLines.dat")).string());
-                fout << "time\tf_x\tf_y\n";
+                std::ofstream fout((outputDir_ / (gcIbObj->name() + "_forces.dat")).string());
+                fout << "time\tf_x\tf_y\ttorque\n";
                 fout.close();
             }
 
@@ -26,6 +29,7 @@ GhostCellImmersedBoundaryObjectForceIntegrator::GhostCellImmersedBoundaryObjectF
         }
     }
 }
+
 void GhostCellImmersedBoundaryObjectForceIntegrator::compute(Scalar time)
 {
     gcIbObjs_.erase(
@@ -35,10 +39,16 @@ void GhostCellImmersedBoundaryObjectForceIntegrator::compute(Scalar time)
             gcIbObjs_.end()
     );
 
-    for(auto ptr: gcIbObjs_)
+    if (iterNo_++ % fileWriteFrequency_ != 0 || !solver_.grid().comm().isMainProc())
+        return;
+
+    //- The forces are integrated and reduced once per step by the immersed boundary, so they are only written here
+    for (auto ptr: gcIbObjs_)
     {
         auto gcIbObj = ptr.lock();
 
-
+        std::ofstream fout((outputDir_ / (gcIbObj->name() + "_forces.dat")).string(), std::ofstream::app);
+        fout << std::setprecision(std::numeric_limits<Scalar>::digits10)
+             << time << "\t" << gcIbObj->force().x << "\t" << gcIbObj->force().y << "\t" << gcIbObj->torque() << "\n";
     }
 }
@@ -0,0 +1,35 @@
+#include "LineSampler.h"
+
+LineSampler::LineSampler(const Solver &solver,
+                         const std::string &name,
+                         const std::vector<std::string> &fieldNames,
+                         const std::vector<Point2D> &vertices,
+                         int nPoints)
+        :
+        FieldSampler(solver, name, fieldNames, "LineSamplers")
+{
+    if (vertices.size() < 2 || nPoints < 2)
+        throw Exception("LineSampler", "LineSampler", "a line requires at least two vertices and two points.");
+
+    std::vector<Scalar> length(1, 0.);
+
+    for (int i = 1; i < vertices.size(); ++i)
+        length.push_back(length.back() + (vertices[i] - vertices[i - 1]).mag());
+
+    std::vector<Point2D> points;
+
+    for (int i = 0, seg = 1; i < nPoints; ++i)
+    {
+        Scalar s = length.back() * i / (nPoints - 1);
+
+        while (seg < vertices.size() - 1 && s > length[seg])
+            ++seg;
+
+        Scalar ds = length[seg] - length[seg - 1];
+        Scalar t = ds > 0. ? (s - length[seg - 1]) / ds : 0.;
+
+        points.push_back(vertices[seg - 1] + t * (vertices[seg] - vertices[seg - 1]));
+    }
+
+    setSamplePoints(points);
+}
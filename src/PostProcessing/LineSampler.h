@@ -0,0 +1,18 @@
+#ifndef LINE_SAMPLER_H
+#define LINE_SAMPLER_H
+
+#include "FieldSampler.h"
+
+//- Samples at nPoints uniformly spaced along a polyline, including its end points
+class LineSampler : public FieldSampler
+{
+public:
+
+    LineSampler(const Solver &solver,
+                const std::string &name,
+                const std::vector<std::string> &fieldNames,
+                const std::vector<Point2D> &vertices,
+                int nPoints);
+};
+
+#endif
@@ -1,10 +1,43 @@
+#include <regex>
+
+#include <boost/algorithm/string.hpp>
+
 #include "PostProcessing.h"
 #include "VolumeIntegrator.h"
+#include "Probes.h"
+#include "LineSampler.h"
+#include "SubRegionSampler.h"
+#include "Statistics.h"
 #include "IbTracker.h"
 #include "GhostCellImmersedBoundaryObjectForceIntegrator.h"
 #include "GhostCellImmersedBoundaryObjectContactLineTracker.h"
 
-PostProcessing::PostProcessing(const Input &input, const Solver &solver)
+namespace
+{
+    std::vector<std::string> fieldNames(const boost::property_tree::ptree &input)
+    {
+        std::vector<std::string> names;
+        std::string fields = input.get<std::string>("fields");
+        boost::split(names, fields, boost::is_any_of(", "), boost::token_compress_on);
+        names.erase(std::remove(names.begin(), names.end(), ""), names.end());
+
+        return names;
+    }
+
+    //- A list of points of the form "(x1,y1) (x2,y2) ..."
+    std::vector<Point2D> points(const std::string &str)
+    {
+        std::vector<Point2D> pts;
+        std::regex re("\\([^()]*\\)");
+
+        for (std::sregex_iterator it(str.begin(), str.end(), re), end; it != end; ++it)
+            pts.push_back(Point2D(it->str()));
+
+        return pts;
+    }
+}
+
+PostProcessing::PostProcessing(const Input &input, Solver &solver, Viewer &viewer)
 {
     auto postProcessingInput = input.postProcessingInput().get_child_optional("PostProcessing");
     int defaultFileWriteFrequency = input.caseInput().get<int>("System.fileWriteFrequency", 1);
@@ -38,12 +71,62 @@ PostProcessing::PostProcessing(const Input &input, const Solver &solver)
             {
                 postProcessingObj = std::make_shared<GhostCellImmersedBoundaryObjectContactLineTracker>(solver);
             }
+            else if (postProcessingObjectInput.first == "Probes")
+            {
+                postProcessingObj = std::make_shared<Probes>(
+                        solver,
+                        postProcessingObjectInput.second.get<std::string>("name", "Probes"),
+                        fieldNames(postProcessingObjectInput.second),
+                        points(postProcessingObjectInput.second.get<std::string>("points"))
+                );
+            }
+            else if (postProcessingObjectInput.first == "LineSampler")
+            {
+                postProcessingObj = std::make_shared<LineSampler>(
+                        solver,
+                        postProcessingObjectInput.second.get<std::string>("name", "Line"),
+                        fieldNames(postProcessingObjectInput.second),
+                        points(postProcessingObjectInput.second.get<std::string>("vertices")),
+                        postProcessingObjectInput.second.get<int>("nPoints")
+                );
+            }
+            else if (postProcessingObjectInput.first == "SubRegionSampler")
+            {
+                postProcessingObj = std::make_shared<SubRegionSampler>(
+                        solver,
+                        postProcessingObjectInput.second.get<std::string>("name", "SubRegion"),
+                        fieldNames(postProcessingObjectInput.second),
+                        Box(postProcessingObjectInput.second.get<std::string>("lower"),
+                            postProcessingObjectInput.second.get<std::string>("upper"))
+                );
+            }
+
+            else if (postProcessingObjectInput.first == "Statistics")
+            {
+                postProcessingObj = std::make_shared<Statistics>(
+                        solver,
+                        viewer,
+                        postProcessingObjectInput.second.get<std::string>("name", "Statistics"),
+                        fieldNames(postProcessingObjectInput.second),
+                        postProcessingObjectInput.second.get<Scalar>("startTime", 0.)
+                );
+            }
+
+            if (auto sampler = std::dynamic_pointer_cast<FieldSampler>(postProcessingObj))
+            {
+                sampler->setBufferSize(postProcessingObjectInput.second.get<int>("bufferSize", 100));
+                sampler->setAppend(
+                        input.initialConditionInput().get<std::string>("InitialConditions.type", "") == "restart");
+            }
 
             if (postProcessingObj)
             {
                 postProcessingObjs_.push_back(postProcessingObj);
+                //- Statistics sample every time step by default
                 postProcessingObj->setFileWriteFrequency(
-                        postProcessingObjectInput.second.get<int>("fileWriteFrequency", defaultFileWriteFrequency)
+                        postProcessingObjectInput.second.get<int>(
+                                "fileWriteFrequency",
+                                postProcessingObjectInput.first == "Statistics" ? 1 : defaultFileWriteFrequency)
                 );
             }
         }
@@ -54,4 +137,10 @@ void PostProcessing::compute(Scalar time) const
 {
     for (auto obj: postProcessingObjs_)
         obj->compute(time);
-}
\ No newline at end of file
+}
+
+void PostProcessing::updateGrid() const
+{
+    for (auto obj: postProcessingObjs_)
+        obj->updateGrid();
+}
@@ -5,16 +5,19 @@
 
 #include "PostProcessingObject.h"
 #include "Input.h"
+#include "Viewer.h"
 
 class PostProcessing
 {
 
 public:
 
-    PostProcessing(const Input &input, const Solver &solver);
+    PostProcessing(const Input &input, Solver &solver, Viewer &viewer);
 
     void compute(Scalar time) const;
 
+    void updateGrid() const;
+
 private:
 
     std::vector<std::shared_ptr<PostProcessingObject>> postProcessingObjs_;
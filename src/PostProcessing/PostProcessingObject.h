@@ -17,6 +17,9 @@ public:
 
     virtual void compute(Scalar time) = 0;
 
+    //- Called after the grid has been repartitioned
+    virtual void updateGrid() {}
+
     void setFileWriteFrequency(int fileWriteFrequency)
     { fileWriteFrequency_ = fileWriteFrequency; }
 
@@ -0,0 +1,11 @@
+#include "Probes.h"
+
+Probes::Probes(const Solver &solver,
+               const std::string &name,
+               const std::vector<std::string> &fieldNames,
+               const std::vector<Point2D> &points)
+        :
+        FieldSampler(solver, name, fieldNames, "Probes")
+{
+    setSamplePoints(points);
+}
@@ -0,0 +1,16 @@
+#ifndef PROBES_H
+#define PROBES_H
+
+#include "FieldSampler.h"
+
+class Probes : public FieldSampler
+{
+public:
+
+    Probes(const Solver &solver,
+           const std::string &name,
+           const std::vector<std::string> &fieldNames,
+           const std::vector<Point2D> &points);
+};
+
+#endif
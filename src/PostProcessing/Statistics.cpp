@@ -0,0 +1,92 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Statistics.h"
+
+Statistics::Statistics(Solver &solver,
+                       Viewer &viewer,
+                       const std::string &name,
+                       const std::vector<std::string> &fieldNames,
+                       Scalar startTime)
+        :
+        PostProcessingObject(solver),
+        startTime_(startTime),
+        nSamples_(solver.addIntegerField(name + "Samples"))
+{
+    for (const std::string &fieldName: fieldNames)
+    {
+        if (solver.scalarFields().find(fieldName) != solver.scalarFields().end())
+            scalarMoments_.push_back(addMoments(solver, viewer, solver.scalarField(fieldName)));
+        else if (solver.vectorFields().find(fieldName) != solver.vectorFields().end())
+            vectorMoments_.push_back(addMoments(solver, viewer, solver.vectorField(fieldName)));
+        else
+            throw Exception("Statistics", "Statistics", "no scalar or vector field \"" + fieldName + "\".");
+    }
+}
+
+void Statistics::compute(Scalar time)
+{
+    if (time < startTime_ || iterNo_++ % fileWriteFrequency_ != 0)
+        return;
+
+    //- All cells are updated, so that buffer cells stay consistent without an exchange
+    for (const Moments<ScalarFiniteVolumeField> &m: scalarMoments_)
+    {
+        const ScalarFiniteVolumeField &field = m.field;
+        ScalarFiniteVolumeField &mean = m.mean, &rms = m.rms, &min = m.min, &max = m.max;
+
+        for (Label i = 0; i < field.size(); ++i)
+            update(field[i], nSamples_[i], mean[i], rms[i], min[i], max[i]);
+    }
+
+    for (const Moments<VectorFiniteVolumeField> &m: vectorMoments_)
+    {
+        const VectorFiniteVolumeField &field = m.field;
+        VectorFiniteVolumeField &mean = m.mean, &rms = m.rms, &min = m.min, &max = m.max;
+
+        for (Label i = 0; i < field.size(); ++i)
+        {
+            update(field[i].x, nSamples_[i], mean[i].x, rms[i].x, min[i].x, max[i].x);
+            update(field[i].y, nSamples_[i], mean[i].y, rms[i].y, min[i].y, max[i].y);
+        }
+    }
+
+    for (int &n: nSamples_)
+        ++n;
+}
+
+//- Private methods
+
+template<class T>
+Statistics::Moments<T> Statistics::addMoments(Solver &solver, Viewer &viewer, const T &field)
+{
+    auto add = [&solver, &viewer, &field](const std::string &suffix) -> T & {
+        T &stat = addField(solver, field.name() + suffix, field);
+        viewer.addField(stat);
+        return stat;
+    };
+
+    return Moments<T>{std::cref(field), std::ref(add("Mean")), std::ref(add("Rms")),
+                      std::ref(add("Min")), std::ref(add("Max"))};
+}
+
+void Statistics::update(Scalar x, int n, Scalar &mean, Scalar &rms, Scalar &min, Scalar &max)
+{
+    if (n == 0)
+    {
+        mean = min = max = x;
+        rms = 0.;
+        return;
+    }
+
+    //- The sum of squared deviations is recovered from the rms, so only the checkpointed fields are needed
+    Scalar m2 = rms * rms * n;
+    Scalar delta = x - mean;
+
+    mean += delta / (n + 1);
+    m2 += delta * (x - mean);
+
+    rms = std::sqrt(m2 / (n + 1));
+    min = std::min(min, x);
+    max = std::max(max, x);
+}
@@ -0,0 +1,52 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "PostProcessingObject.h"
+#include "Viewer.h"
+
+//- Running time statistics (mean, rms fluctuation, min and max) of fields, accumulated in-situ from startTime with
+//- Welford's algorithm. The statistics are solver fields, so they are written by the viewer, checkpointed and
+//- redistributed with the other fields, and accumulation continues after a restart
+class Statistics : public PostProcessingObject
+{
+public:
+
+    Statistics(Solver &solver,
+               Viewer &viewer,
+               const std::string &name,
+               const std::vector<std::string> &fieldNames,
+               Scalar startTime);
+
+    void compute(Scalar time);
+
+private:
+
+    template<class T>
+    struct Moments
+    {
+        Ref<const T> field;
+        Ref<T> mean, rms, min, max;
+    };
+
+    template<class T>
+    Moments<T> addMoments(Solver &solver, Viewer &viewer, const T &field);
+
+    static ScalarFiniteVolumeField &addField(Solver &solver, const std::string &name, const ScalarFiniteVolumeField &)
+    { return solver.addScalarField(name); }
+
+    static VectorFiniteVolumeField &addField(Solver &solver, const std::string &name, const VectorFiniteVolumeField &)
+    { return solver.addVectorField(name); }
+
+    //- Welford update of a cell with its n + 1th sample
+    static void update(Scalar x, int n, Scalar &mean, Scalar &rms, Scalar &min, Scalar &max);
+
+    Scalar startTime_;
+
+    //- Number of samples accumulated in each cell
+    FiniteVolumeField<int> &nSamples_;
+
+    std::vector<Moments<ScalarFiniteVolumeField>> scalarMoments_;
+    std::vector<Moments<VectorFiniteVolumeField>> vectorMoments_;
+};
+
+#endif
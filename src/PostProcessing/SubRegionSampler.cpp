@@ -0,0 +1,16 @@
+#include "SubRegionSampler.h"
+
+SubRegionSampler::SubRegionSampler(const Solver &solver,
+                                   const std::string &name,
+                                   const std::vector<std::string> &fieldNames,
+                                   const Box &box)
+        :
+        FieldSampler(solver, name, fieldNames, "SubRegions")
+{
+    //- Cells inside immersed bodies are sampled too, so that the region does not change as they move
+    std::vector<Ref<const Cell>> cells = solver.grid().localActiveCells().itemsWithin(box);
+    std::vector<Ref<const Cell>> inactiveCells = solver.grid().localInactiveCells().itemsWithin(box);
+    cells.insert(cells.end(), inactiveCells.begin(), inactiveCells.end());
+
+    setSampleCells(cells);
+}
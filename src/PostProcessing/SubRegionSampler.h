@@ -0,0 +1,18 @@
+#ifndef SUB_REGION_SAMPLER_H
+#define SUB_REGION_SAMPLER_H
+
+#include "FieldSampler.h"
+#include "Box.h"
+
+//- Samples the cell values of all cells whose centroids are within a box
+class SubRegionSampler : public FieldSampler
+{
+public:
+
+    SubRegionSampler(const Solver &solver,
+                     const std::string &name,
+                     const std::vector<std::string> &fieldNames,
+                     const Box &box);
+};
+
+#endif
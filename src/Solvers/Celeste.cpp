@@ -82,6 +82,16 @@ void Celeste::constructMatrices()
     }
 }
 
+void Celeste::endRedistribution()
+{
+    SurfaceTensionForce::endRedistribution();
+
+    //- Stencils reference cells of the previous local domain
+    kappaStencils_.clear();
+    gradGammaTildeStencils_.clear();
+    constructMatrices();
+}
+
 Equation<Scalar> Celeste::contactLineBcs(const ImmersedBoundary &ib)
 {
     Equation<Scalar> eqn(gamma_);
@@ -29,6 +29,8 @@ public:
 
     Equation<Scalar> contactLineBcs(const ImmersedBoundary& ib);
 
+    void endRedistribution();
+
 protected:
 
     class CelesteStencil
@@ -45,12 +45,22 @@ Scalar FractionalStep::solve(Scalar timeStep)
     solvePEqn(timeStep);
     correctVelocity(timeStep);
 
-    printf("Max divergence error = %.4e\n", grid_->comm().max(maxDivergenceError()));
-    printf("Max CFL number = %.4lf\n", maxCourantNumber(timeStep));
+    //- Diagnostics are reduced together, overlapped with the ib update
+    Reduction diagnostics(grid_->comm());
+    Size maxDivError = diagnostics.add(maxDivergenceError(), Reduction::MAX);
+    Size maxCo = diagnostics.add(maxCourantNumber(timeStep), Reduction::MAX);
+    diagnostics.ireduce();
 
     ib_.update(timeStep);
     ib_.computeForce(rho_, mu_, u, p, g_);
 
+    diagnostics.wait();
+    maxCo_ = diagnostics.scalar(maxCo);
+    maxCoTimeStep_ = timeStep;
+
+    printf("Max divergence error = %.4e\n", diagnostics.scalar(maxDivError));
+    printf("Max CFL number = %.4lf\n", maxCo_);
+
     return 0;
 }
 
@@ -72,19 +82,21 @@ Scalar FractionalStep::maxCourantNumber(Scalar timeStep) const
         maxCo = std::max(co, maxCo);
     }
 
-    return grid_->comm().max(maxCo);
+    return maxCo;
 }
 
 Scalar FractionalStep::computeMaxTimeStep(Scalar maxCo, Scalar prevTimeStep) const
 {
-    Scalar co = maxCourantNumber(prevTimeStep);
+    //- The Courant number is linear in the time step, so the value reduced during the last solve can be reused
+    Scalar co = maxCoTimeStep_ > 0. ? maxCo_ * prevTimeStep / maxCoTimeStep_
+                                    : grid_->comm().max(maxCourantNumber(prevTimeStep));
     Scalar lambda1 = 0.1, lambda2 = 1.2;
 
-    return grid_->comm().min(
-            std::min(
-                    std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
-                    std::min(lambda2 * prevTimeStep, maxTimeStep_)
-            ));
+    //- All args are already global, no reduction required
+    return std::min(
+            std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
+            std::min(lambda2 * prevTimeStep, maxTimeStep_)
+    );
 }
 
 Scalar FractionalStep::solveUEqn(Scalar timeStep)
@@ -126,10 +138,13 @@ void FractionalStep::correctVelocity(Scalar timeStep)
     for (const Cell &cell: fluid_)
         u(cell) -= timeStep / rho_ * gradP(cell);
 
-    grid_->sendMessages(u); //- Necessary
+    //- The face corrections do not depend on the cell values, so they are computed while the cells are exchanged
+    const auto &faces = grid_->interiorFaces().items();
 
-    for (const Face &face: grid_->interiorFaces())
+    grid_->sendMessages(u, 1, faces.size(), [this, &faces, timeStep](Size i) {
+        const Face &face = faces[i];
         u(face) -= timeStep / rho_ * gradP(face);
+    });
 
     for (const Patch &patch: grid_->patches())
         switch (u.boundaryType(patch))
@@ -161,8 +176,8 @@ Scalar FractionalStep::maxDivergenceError()
         for (const BoundaryLink &bd: cell.boundaries())
             div += dot(u(bd.face()), bd.outwardNorm());
 
-        maxError = fabs(div) > maxError ? div : maxError;
+        maxError = std::max(fabs(div), maxError);
     }
 
-    return grid_->comm().max(maxError);
+    return maxError;
 }
\ No newline at end of file
@@ -77,5 +77,5 @@ Scalar FractionalStepAxisymmetric::maxDivergenceError()
         maxError = std::abs(divU) > maxError ? std::abs(divU) : maxError;
     }
 
-    return grid_->comm().max(maxError);
+    return maxError;
 }
\ No newline at end of file
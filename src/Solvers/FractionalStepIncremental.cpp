@@ -45,21 +45,22 @@ Scalar FractionalStepIncremental::solve(Scalar timeStep)
 
     //ib_.update(timeStep);
 
-    printf("Max Co = %lf\n", maxCourantNumber(timeStep));
-    printf("Max divergence error = %.4e\n", maxDivergenceError());
+    Reduction diagnostics(grid_->comm());
+    Size maxCo = diagnostics.add(maxCourantNumber(timeStep), Reduction::MAX);
+    Size maxDivError = diagnostics.add(maxDivergenceError(), Reduction::MAX);
+    diagnostics.reduce();
+
+    maxCo_ = diagnostics.scalar(maxCo);
+    maxCoTimeStep_ = timeStep;
+
+    printf("Max Co = %lf\n", maxCo_);
+    printf("Max divergence error = %.4e\n", diagnostics.scalar(maxDivError));
 
     return 0.;
 }
 
 //- Protected methods
 
-void FractionalStepIncremental::restartSolution()
-{
-    Solver::restartSolution();
-    u.interpolateFaces();
-    p.interpolateFaces();
-}
-
 Scalar FractionalStepIncremental::solveUEqn(Scalar timeStep)
 {
     u.savePreviousTimeStep(timeStep, 1);
@@ -158,19 +159,21 @@ Scalar FractionalStepIncremental::maxCourantNumber(Scalar timeStep) const
         maxCo = std::max(co * timeStep / cell.volume(), maxCo);
     }
 
-    return grid_->comm().max(maxCo);
+    return maxCo;
 }
 
 Scalar FractionalStepIncremental::computeMaxTimeStep(Scalar maxCo, Scalar prevTimeStep) const
 {
-    Scalar co = maxCourantNumber(prevTimeStep);
+    //- The Courant number is linear in the time step, so the value reduced during the last solve can be reused
+    Scalar co = maxCoTimeStep_ > 0. ? maxCo_ * prevTimeStep / maxCoTimeStep_
+                                    : grid_->comm().max(maxCourantNumber(prevTimeStep));
     Scalar lambda1 = 0.1, lambda2 = 1.2;
 
-    return grid_->comm().min(
-            std::min(
-                    std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
-                    std::min(lambda2 * prevTimeStep, maxTimeStep_)
-            ));
+    //- All args are already global, no reduction required
+    return std::min(
+            std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
+            std::min(lambda2 * prevTimeStep, maxTimeStep_)
+    );
 }
 
 Scalar FractionalStepIncremental::maxDivergenceError() const
@@ -191,5 +194,5 @@ Scalar FractionalStepIncremental::maxDivergenceError() const
             maxError = fabs(div);
     }
 
-    return grid_->comm().max(maxError);
+    return maxError;
 }
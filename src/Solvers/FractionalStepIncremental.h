@@ -21,6 +21,7 @@ public:
 
     virtual Scalar solve(Scalar timeStep);
 
+    //- Max Courant number on this proc, reduce globally with a Reduction
     Scalar maxCourantNumber(Scalar timeStep) const;
 
     virtual Scalar computeMaxTimeStep(Scalar maxCo, Scalar prevTimeStep) const;
@@ -32,8 +33,6 @@ public:
 
 protected:
 
-    virtual void restartSolution();
-
     virtual Scalar solveUEqn(Scalar timeStep);
 
     virtual Scalar solvePEqn(Scalar timeStep);
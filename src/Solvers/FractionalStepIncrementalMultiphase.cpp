@@ -64,8 +64,16 @@ Scalar FractionalStepIncrementalMultiphase::solve(Scalar timeStep)
     solvePEqn(timeStep); //- Solve the pressure equation, using sharp value of rho
     correctVelocity(timeStep);
 
-    grid_->comm().printf("Max Co = %lf\n", maxCourantNumber(timeStep));
-    grid_->comm().printf("Max absolute velocity divergence error = %.4e\n", maxDivergenceError());
+    Reduction diagnostics(grid_->comm());
+    Size maxCo = diagnostics.add(maxCourantNumber(timeStep), Reduction::MAX);
+    Size maxDivError = diagnostics.add(maxDivergenceError(), Reduction::MAX);
+    diagnostics.reduce();
+
+    maxCo_ = diagnostics.scalar(maxCo);
+    maxCoTimeStep_ = timeStep;
+
+    grid_->comm().printf("Max Co = %lf\n", maxCo_);
+    grid_->comm().printf("Max absolute velocity divergence error = %.4e\n", diagnostics.scalar(maxDivError));
 
     return 0.;
 }
@@ -59,11 +59,21 @@ Scalar FractionalStepMultiphase::solve(Scalar timeStep)
     solvePEqn(timeStep);
     correctVelocity(timeStep);
 
+    //- Diagnostics are reduced together, overlapped with the ib update
+    Reduction diagnostics(grid_->comm());
+    Size maxDivError = diagnostics.add(maxDivergenceError(), Reduction::MAX);
+    Size maxCo = diagnostics.add(maxCourantNumber(timeStep), Reduction::MAX);
+    diagnostics.ireduce();
+
     //ib_.computeForce(rho, mu, u, p, g_);
     ib_.update(timeStep);
 
-    printf("Max divergence error = %.4e\n", grid_->comm().max(maxDivergenceError()));
-    printf("Max CFL number = %.4lf\n", maxCourantNumber(timeStep));
+    diagnostics.wait();
+    maxCo_ = diagnostics.scalar(maxCo);
+    maxCoTimeStep_ = timeStep;
+
+    printf("Max divergence error = %.4e\n", diagnostics.scalar(maxDivError));
+    printf("Max CFL number = %.4lf\n", maxCo_);
 
     return 0;
 }
@@ -27,6 +27,12 @@ Scalar FractionalStepMultiphaseQuadraticIbm::solve(Scalar timeStep)
     solvePEqn(timeStep);
     correctVelocity(timeStep);
 
+    //- Diagnostics are reduced together, overlapped with the ib update
+    Reduction diagnostics(grid_->comm());
+    Size maxDivError = diagnostics.add(maxDivergenceError(), Reduction::MAX);
+    Size maxCo = diagnostics.add(maxCourantNumber(timeStep), Reduction::MAX);
+    diagnostics.ireduce();
+
     ib_.computeForce(rho, mu, u, p, g_);
     //ib_.computeForce(rho1_, mu1_, u, p, g_);
     ib_.update(timeStep);
@@ -35,8 +41,12 @@ Scalar FractionalStepMultiphaseQuadraticIbm::solve(Scalar timeStep)
     for (const Cell &cell: grid_->cells())
         ps(cell) = p(cell) + rho(cell) * dot(g_, cell.centroid());
 
-    grid_->comm().printf("Max divergence error = %.4e\n", grid_->comm().max(maxDivergenceError()));
-    grid_->comm().printf("Max CFL number = %.4lf\n", maxCourantNumber(timeStep));
+    diagnostics.wait();
+    maxCo_ = diagnostics.scalar(maxCo);
+    maxCoTimeStep_ = timeStep;
+
+    grid_->comm().printf("Max divergence error = %.4e\n", diagnostics.scalar(maxDivError));
+    grid_->comm().printf("Max CFL number = %.4lf\n", maxCo_);
 
     return 0;
 }
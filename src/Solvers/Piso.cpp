@@ -59,7 +59,10 @@ Scalar Piso::solve(Scalar timeStep)
         }
     }
 
-    printf("Max Co = %lf\n", maxCourantNumber(timeStep));
+    maxCo_ = grid_->comm().max(maxCourantNumber(timeStep));
+    maxCoTimeStep_ = timeStep;
+
+    printf("Max Co = %lf\n", maxCo_);
 
     return 0.;
 }
@@ -82,19 +85,21 @@ Scalar Piso::maxCourantNumber(Scalar timeStep) const
         maxCo = std::max(co, maxCo);
     }
 
-    return grid_->comm().max(maxCo);
+    return maxCo;
 }
 
 Scalar Piso::computeMaxTimeStep(Scalar maxCo, Scalar prevTimeStep) const
 {
-    Scalar co = maxCourantNumber(prevTimeStep);
+    //- The Courant number is linear in the time step, so the value reduced during the last solve can be reused
+    Scalar co = maxCoTimeStep_ > 0. ? maxCo_ * prevTimeStep / maxCoTimeStep_
+                                    : grid_->comm().max(maxCourantNumber(prevTimeStep));
     Scalar lambda1 = 0.05, lambda2 = 1.1;
 
-    return grid_->comm().min(
-            std::min(
-                    std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
-                    std::min(lambda2 * prevTimeStep, maxTimeStep_)
-            ));
+    //- All args are already global, no reduction required
+    return std::min(
+            std::min(maxCo / co * prevTimeStep, (1 + lambda1 * maxCo / co) * prevTimeStep),
+            std::min(lambda2 * prevTimeStep, maxTimeStep_)
+    );
 }
 
 //- Protected methods
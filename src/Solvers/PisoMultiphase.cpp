@@ -68,7 +68,10 @@ Scalar PisoMultiphase::solve(Scalar timeStep)
 
     solveGammaEqn(timeStep);
 
-    printf("Max Co = %lf\n", maxCourantNumber(timeStep));
+    maxCo_ = grid_->comm().max(maxCourantNumber(timeStep));
+    maxCoTimeStep_ = timeStep;
+
+    printf("Max Co = %lf\n", maxCo_);
 
     return 0.; // just to get rid of warning
 }
@@ -1,5 +1,12 @@
 #include <math.h>
+#include <map>
+#include <fstream>
+#include <numeric>
 #include <regex>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <limits>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -8,6 +15,7 @@
 #include "Solver.h"
 #include "FaceInterpolation.h"
 #include "EigenSparseMatrixSolver.h"
+#include "BinaryStream.h"
 
 Solver::Solver(const Input &input, std::shared_ptr<FiniteVolumeGrid2D> &grid)
         :
@@ -31,28 +39,81 @@ void Solver::printf(const char *format, ...) const
 
 Scalar Solver::getStartTime(const Input &input) const
 {
-    if (input.initialConditionInput().get<std::string>("InitialConditions.type", "") == "restart")
+    if (input.initialConditionInput().get<std::string>("InitialConditions.type", "") != "restart")
+        return 0.;
+
+    if (CheckpointHeader::exists())
     {
-        using namespace std;
-        using namespace boost::filesystem;
+        std::ifstream fin;
+        CheckpointHeader::open(0, fin);
+        return CheckpointHeader(fin).time;
+    }
 
-        std::regex re("[0-9]+\\.[0-9]+");
-        Scalar maxTime = 0.;
+    using namespace std;
+    using namespace boost::filesystem;
 
-        for (directory_iterator end, dir("./solution"); dir != end; ++dir)
-            if (regex_match(dir->path().filename().string(), re))
-            {
-                std::smatch match;
-                std::regex_search(dir->path().filename().string(), match, re);
-                Scalar time = std::stod(match.str());
+    std::regex re("[0-9]+\\.[0-9]+");
+    Scalar maxTime = 0.;
 
-                maxTime = std::max(time, maxTime);
-            }
+    for (directory_iterator end, dir("./solution"); dir != end; ++dir)
+        if (regex_match(dir->path().filename().string(), re))
+        {
+            std::smatch match;
+            std::regex_search(dir->path().filename().string(), match, re);
+            Scalar time = std::stod(match.str());
+
+            maxTime = std::max(time, maxTime);
+        }
+
+    return maxTime;
+}
 
-        return maxTime;
+Scalar Solver::getStartTimeStep(const Input &input) const
+{
+    if (input.initialConditionInput().get<std::string>("InitialConditions.type", "") == "restart"
+        && CheckpointHeader::exists())
+    {
+        std::ifstream fin;
+        CheckpointHeader::open(0, fin);
+        return CheckpointHeader(fin).timeStep;
     }
 
-    return 0.;
+    return input.caseInput().get<Scalar>("Solver.initialTimeStep", maxTimeStep_);
+}
+
+void Solver::writeCheckpoint(Scalar time, Scalar timeStep) const
+{
+    const Communicator &comm = grid_->comm();
+    std::string filename = CheckpointHeader::filename(comm.rank());
+
+    if (comm.isMainProc())
+        boost::filesystem::create_directories("checkpoint");
+
+    comm.barrier();
+
+    //- Written to a temporary file first so that the previous checkpoint survives a failed write
+    std::ofstream fout(filename + ".tmp", std::ios::binary);
+
+    CheckpointHeader(comm.nProcs(), time, timeStep).write(fout);
+
+    //- Serial ids, so that the checkpoint can be read on any decomposition
+    writeBinary(fout, serialIds(grid_->globalCellIds(), grid_->nCells()));
+    writeBinary(fout, serialIds(grid_->globalFaceIds(), grid_->nFaces()));
+    writeBinary(fout, serialIds(grid_->globalNodeIds(), grid_->nNodes()));
+
+    writeCheckpointFields(fout, integerFields_);
+    writeCheckpointFields(fout, scalarFields_);
+    writeCheckpointFields(fout, vectorFields_);
+    writeCheckpointFields(fout, tensorFields_);
+
+    ib_.writeCheckpoint(fout);
+
+    fout.close();
+
+    if (comm.min((int) fout.good()) == 0)
+        throw Exception("Solver", "writeCheckpoint", "failed to write checkpoint.");
+
+    boost::filesystem::rename(filename + ".tmp", filename);
 }
 
 FiniteVolumeField<int> &Solver::addIntegerField(const std::string &name)
@@ -109,6 +170,52 @@ VectorFiniteVolumeField &Solver::addVectorField(const std::string &name)
     return *insert.first->second;
 }
 
+void Solver::repartition(const Input &input, const std::vector<Scalar> &cellWeights)
+{
+    if (grid_->comm().nProcs() == 1)
+        return;
+
+    //- Fields are staged in name order so that the collectives match on all procs
+    std::map<std::string, std::shared_ptr<FiniteVolumeField<int>>> integerFields(integerFields_.begin(),
+                                                                                 integerFields_.end());
+    std::map<std::string, std::shared_ptr<ScalarFiniteVolumeField>> scalarFields(scalarFields_.begin(),
+                                                                                scalarFields_.end());
+    std::map<std::string, std::shared_ptr<VectorFiniteVolumeField>> vectorFields(vectorFields_.begin(),
+                                                                                vectorFields_.end());
+    std::map<std::string, std::shared_ptr<TensorFiniteVolumeField>> tensorFields(tensorFields_.begin(),
+                                                                                tensorFields_.end());
+
+    for (auto &field: integerFields)
+        field.second->beginRedistribution();
+
+    for (auto &field: scalarFields)
+        field.second->beginRedistribution();
+
+    for (auto &field: vectorFields)
+        field.second->beginRedistribution();
+
+    for (auto &field: tensorFields)
+        field.second->beginRedistribution();
+
+    ib_.clearCellZones();
+    grid_->repartition(input, cellWeights);
+
+    for (auto &field: integerFields)
+        field.second->endRedistribution();
+
+    for (auto &field: scalarFields)
+        field.second->endRedistribution();
+
+    for (auto &field: vectorFields)
+        field.second->endRedistribution();
+
+    for (auto &field: tensorFields)
+        field.second->endRedistribution();
+
+    //- Reclassify the ib cells, also recomputes the global ordering
+    ib_.resetCellZones();
+}
+
 void Solver::setInitialConditions(const Input &input)
 {
     using namespace std;
@@ -417,10 +524,121 @@ void Solver::setRotating(const std::string &xFunction, const std::string &yFunct
 }
 
 void Solver::restartSolution()
+{
+    const Communicator &comm = grid_->comm();
+
+    if (!CheckpointHeader::exists())
+    {
+        restartCgnsSolution();
+        return;
+    }
+
+    std::ifstream fin;
+    CheckpointHeader::open(0, fin);
+    int nProcs = CheckpointHeader(fin).nProcs;
+
+    if (nProcs != comm.nProcs())
+    {
+        restartRedistributedSolution(nProcs);
+        return;
+    }
+
+    CheckpointHeader::open(comm.rank(), fin);
+    CheckpointHeader header(fin);
+
+    if (comm.min(header.time) != comm.max(header.time))
+        throw Exception("Solver", "restartSolution", "checkpoint files were written at different times.");
+
+    std::vector<Label> globalCellIds, globalFaceIds, globalNodeIds;
+    readBinary(fin, globalCellIds);
+    readBinary(fin, globalFaceIds);
+    readBinary(fin, globalNodeIds);
+
+    //- The grid may have been partitioned differently, e.g. after load balancing
+    if (comm.max((int) (globalCellIds != serialIds(grid_->globalCellIds(), grid_->nCells())
+                        || globalFaceIds != serialIds(grid_->globalFaceIds(), grid_->nFaces())
+                        || globalNodeIds != serialIds(grid_->globalNodeIds(), grid_->nNodes()))))
+    {
+        restartRedistributedSolution(nProcs);
+        return;
+    }
+
+    readCheckpointFields(fin, integerFields_);
+    readCheckpointFields(fin, scalarFields_);
+    readCheckpointFields(fin, vectorFields_);
+    readCheckpointFields(fin, tensorFields_);
+
+    ib_.readCheckpoint(fin);
+}
+
+void Solver::restartRedistributedSolution(int nProcs)
+{
+    const Communicator &comm = grid_->comm();
+
+    //- Each proc reads a slice of the checkpoint files, the entries are then routed to their procs by serial id
+    std::vector<std::unique_ptr<std::ifstream>> files;
+    std::vector<std::istream *> streams;
+    std::vector<Label> globalCellIds, globalFaceIds, globalNodeIds;
+    Scalar minTime = std::numeric_limits<Scalar>::max(), maxTime = std::numeric_limits<Scalar>::lowest();
+
+    for (int proc = comm.rank(); proc < nProcs; proc += comm.nProcs())
+    {
+        files.push_back(std::unique_ptr<std::ifstream>(new std::ifstream));
+        std::ifstream &fin = *files.back();
+
+        CheckpointHeader::open(proc, fin);
+        CheckpointHeader header(fin);
+
+        if (header.nProcs != nProcs)
+            throw Exception("Solver", "restartRedistributedSolution", "checkpoint files are from different runs.");
+
+        minTime = std::min(minTime, header.time);
+        maxTime = std::max(maxTime, header.time);
+
+        std::vector<Label> ids;
+
+        readBinary(fin, ids);
+        globalCellIds.insert(globalCellIds.end(), ids.begin(), ids.end());
+        readBinary(fin, ids);
+        globalFaceIds.insert(globalFaceIds.end(), ids.begin(), ids.end());
+        readBinary(fin, ids);
+        globalNodeIds.insert(globalNodeIds.end(), ids.begin(), ids.end());
+
+        streams.push_back(&fin);
+    }
+
+    if (comm.min(minTime) != comm.max(maxTime))
+        throw Exception("Solver", "restartRedistributedSolution", "checkpoint files were written at different times.");
+
+    CheckpointRedistribution redistribution(comm, globalCellIds, globalFaceIds, globalNodeIds,
+                                            serialIds(grid_->globalCellIds(), grid_->nCells()),
+                                            serialIds(grid_->globalFaceIds(), grid_->nFaces()),
+                                            serialIds(grid_->globalNodeIds(), grid_->nNodes()));
+
+    readCheckpointFields(streams, integerFields_, redistribution);
+    readCheckpointFields(streams, scalarFields_, redistribution);
+    readCheckpointFields(streams, vectorFields_, redistribution);
+    readCheckpointFields(streams, tensorFields_, redistribution);
+
+    //- Immersed boundary state is replicated, so it is taken from the first file, read by the main proc
+    std::string ibState;
+
+    if (comm.isMainProc())
+        ibState.assign(std::istreambuf_iterator<char>(*streams.front()), std::istreambuf_iterator<char>());
+
+    comm.broadcast(comm.mainProcNo(), ibState);
+
+    std::istringstream is(ibState);
+    ib_.readCheckpoint(is);
+}
+
+void Solver::restartCgnsSolution()
 {
     using namespace std;
     using namespace boost::filesystem;
 
+    //- Restart from the last CGNS solution written on the same decomposition. Only the cell values of the
+    //- current fields are available
     std::regex re("[0-9]+\\.[0-9]+");
     Scalar maxTime = 0.;
     path path;
@@ -443,7 +661,7 @@ void Solver::restartSolution()
 
     //- Check to make sure the restart can be done
     if(!exists(path))
-        throw Exception("Solver", "restartSolution", "no file \"" + path.string() + "\" needed for restart.");
+        throw Exception("Solver", "restartCgnsSolution", "no file \"" + path.string() + "\" needed for restart.");
 
     int fn;
     cg_open(path.c_str(), CG_MODE_READ, &fn);
@@ -470,4 +688,90 @@ void Solver::restartSolution()
     }
 
     cg_close(fn);
-}
\ No newline at end of file
+}
+
+std::vector<Label> Solver::serialIds(const std::vector<Label> &globalIds, Size nLocal)
+{
+    if (!globalIds.empty())
+        return globalIds;
+
+    //- A grid that was never partitioned is in serial order
+    std::vector<Label> ids(nLocal);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    return ids;
+}
+
+template<class T>
+void Solver::writeCheckpointFields(std::ostream &os,
+                                   const std::unordered_map<std::string, std::shared_ptr<T>> &fields) const
+{
+    //- Name order, so that the layout does not depend on the hash map
+    std::map<std::string, std::shared_ptr<T>> orderedFields(fields.begin(), fields.end());
+
+    writeBinary(os, (unsigned long) orderedFields.size());
+
+    for (const auto &field: orderedFields)
+    {
+        writeBinary(os, field.first);
+        field.second->writeCheckpoint(os);
+    }
+}
+
+template<class T>
+void Solver::readCheckpointFields(std::istream &is, std::unordered_map<std::string, std::shared_ptr<T>> &fields)
+{
+    unsigned long nFields;
+    readBinary(is, nFields);
+
+    for (int i = 0; i < nFields; ++i)
+    {
+        std::string name;
+        readBinary(is, name);
+
+        auto field = fields.find(name);
+
+        if (field == fields.end())
+            throw Exception("Solver", "readCheckpointFields", "checkpoint field \"" + name + "\" does not exist.");
+
+        field->second->readCheckpoint(is);
+    }
+}
+
+template<class T>
+void Solver::readCheckpointFields(const std::vector<std::istream *> &streams,
+                                  std::unordered_map<std::string, std::shared_ptr<T>> &fields,
+                                  const CheckpointRedistribution &redistribution)
+{
+    const Communicator &comm = grid_->comm();
+
+    //- All checkpoints hold the same fields, the names are taken from the first one read by the main proc
+    unsigned long nFields = 0;
+    std::vector<std::string> names;
+
+    for (std::istream *is: streams)
+        readBinary(*is, nFields);
+
+    nFields = comm.broadcast(comm.mainProcNo(), (int) nFields);
+
+    for (int i = 0; i < nFields; ++i)
+    {
+        names.assign(streams.size(), "");
+
+        for (Label j = 0; j < streams.size(); ++j)
+            readBinary(*streams[j], names[j]);
+
+        std::string name = names.empty() ? "" : names.front();
+        comm.broadcast(comm.mainProcNo(), name);
+
+        if (std::count(names.begin(), names.end(), name) != names.size())
+            throw Exception("Solver", "readCheckpointFields", "checkpoint files hold different fields.");
+
+        auto field = fields.find(name);
+
+        if (field == fields.end())
+            throw Exception("Solver", "readCheckpointFields", "checkpoint field \"" + name + "\" does not exist.");
+
+        field->second->readCheckpoint(streams, redistribution);
+    }
+}
@@ -2,6 +2,8 @@
 #define SOLVER_H
 
 #include "Input.h"
+#include "Reduction.h"
+#include "Checkpoint.h"
 #include "ScalarFiniteVolumeField.h"
 #include "VectorFiniteVolumeField.h"
 #include "TensorFiniteVolumeField.h"
@@ -33,6 +35,12 @@ public:
 
     Scalar getStartTime(const Input& input) const;
 
+    Scalar getStartTimeStep(const Input& input) const;
+
+    //- Checkpointing, one binary file per proc with the full field and immersed boundary state. Restarts on a
+    //- different number of procs are redistributed using the serial ids stored with the checkpoint
+    void writeCheckpoint(Scalar time, Scalar timeStep) const;
+
     //- Field management
 
     FiniteVolumeField<int> &addIntegerField(const std::string &name);
@@ -131,6 +139,9 @@ public:
 
     virtual void initialize() {}
 
+    //- Load balancing
+    void repartition(const Input &input, const std::vector<Scalar> &cellWeights);
+
 protected:
 
     void setCircle(const Circle &circle, Scalar innerValue, ScalarFiniteVolumeField &field);
@@ -151,6 +162,25 @@ protected:
 
     virtual void restartSolution();
 
+    //- Fallback when no checkpoint exists
+    void restartCgnsSolution();
+
+    void restartRedistributedSolution(int nProcs);
+
+    static std::vector<Label> serialIds(const std::vector<Label> &globalIds, Size nLocal);
+
+    template<class T>
+    void writeCheckpointFields(std::ostream &os,
+                               const std::unordered_map<std::string, std::shared_ptr<T>> &fields) const;
+
+    template<class T>
+    void readCheckpointFields(std::istream &is, std::unordered_map<std::string, std::shared_ptr<T>> &fields);
+
+    template<class T>
+    void readCheckpointFields(const std::vector<std::istream *> &streams,
+                              std::unordered_map<std::string, std::shared_ptr<T>> &fields,
+                              const CheckpointRedistribution &redistribution);
+
     std::shared_ptr<FiniteVolumeGrid2D> grid_;
 
     //- Fields and geometries
@@ -162,6 +192,9 @@ protected:
     //- Solver parameters
     Scalar maxTimeStep_;
 
+    //- Global max Courant number reduced during the last solve, and the time step it was computed with
+    Scalar maxCo_ = 0., maxCoTimeStep_ = 0.;
+
     //- Immersed boundary manager
     ImmersedBoundary ib_;
 };
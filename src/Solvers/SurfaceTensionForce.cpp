@@ -162,3 +162,21 @@ void SurfaceTensionForce::smoothGammaField(const ImmersedBoundary &ib)
     grid_->sendMessages(*gammaTilde_);
     gammaTilde_->setBoundaryFaces();
 }
+
+void SurfaceTensionForce::beginRedistribution()
+{
+    VectorFiniteVolumeField::beginRedistribution();
+    kappa_->beginRedistribution();
+    gammaTilde_->beginRedistribution();
+    gradGammaTilde_->beginRedistribution();
+    n_->beginRedistribution();
+}
+
+void SurfaceTensionForce::endRedistribution()
+{
+    VectorFiniteVolumeField::endRedistribution();
+    kappa_->endRedistribution();
+    gammaTilde_->endRedistribution();
+    gradGammaTilde_->endRedistribution();
+    n_->endRedistribution();
+}
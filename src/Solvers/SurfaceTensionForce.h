@@ -91,6 +91,11 @@ public:
     //- Misc special gamma boundary equations
     virtual Equation<Scalar> contactLineBcs(const ImmersedBoundary &ib) = 0;
 
+    //- Redistribution, includes the internal fields
+    virtual void beginRedistribution();
+
+    virtual void endRedistribution();
+
 protected:
 
     Scalar sigma_, kernelWidth_;
@@ -0,0 +1,61 @@
+#ifndef BINARY_STREAM_H
+#define BINARY_STREAM_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Exception.h"
+
+//- Raw binary i/o of trivially copyable values, vectors and strings, for checkpoints. Vectors and strings are
+//- prefixed with their size
+
+template<class T>
+void writeBinary(std::ostream &os, const T &val)
+{
+    os.write(reinterpret_cast<const char *>(&val), sizeof(T));
+}
+
+template<class T>
+void writeBinary(std::ostream &os, const std::vector<T> &vals)
+{
+    writeBinary(os, (unsigned long) vals.size());
+    os.write(reinterpret_cast<const char *>(vals.data()), sizeof(T) * vals.size());
+}
+
+inline void writeBinary(std::ostream &os, const std::string &str)
+{
+    writeBinary(os, (unsigned long) str.size());
+    os.write(str.data(), str.size());
+}
+
+template<class T>
+void readBinary(std::istream &is, T &val)
+{
+    if (!is.read(reinterpret_cast<char *>(&val), sizeof(T)))
+        throw Exception("", "readBinary", "unexpected end of stream.");
+}
+
+template<class T>
+void readBinary(std::istream &is, std::vector<T> &vals)
+{
+    unsigned long size;
+    readBinary(is, size);
+    vals.resize(size);
+
+    if (!is.read(reinterpret_cast<char *>(vals.data()), sizeof(T) * size))
+        throw Exception("", "readBinary", "unexpected end of stream.");
+}
+
+inline void readBinary(std::istream &is, std::string &str)
+{
+    unsigned long size;
+    readBinary(is, size);
+    str.resize(size);
+
+    if (!is.read(&str[0], size))
+        throw Exception("", "readBinary", "unexpected end of stream.");
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include <unordered_map>
+
+#include "Checkpoint.h"
+#include "BinaryStream.h"
+#include "Exception.h"
+
+std::string CheckpointHeader::filename(int proc)
+{
+    return "checkpoint/Proc" + std::to_string(proc) + ".chk";
+}
+
+bool CheckpointHeader::exists()
+{
+    return std::ifstream(filename(0)).good();
+}
+
+void CheckpointHeader::open(int proc, std::ifstream &fin)
+{
+    fin.close();
+    fin.clear();
+    fin.open(filename(proc), std::ios::binary);
+
+    if (!fin)
+        throw Exception("CheckpointHeader", "open", "no file \"" + filename(proc) + "\" needed for restart.");
+}
+
+CheckpointHeader::CheckpointHeader(int nProcs, Scalar time, Scalar timeStep)
+        :
+        nProcs(nProcs),
+        time(time),
+        timeStep(timeStep)
+{
+
+}
+
+CheckpointHeader::CheckpointHeader(std::istream &is)
+{
+    std::string magic;
+    int fileVersion;
+
+    readBinary(is, magic);
+
+    if (magic != "PhaseCheckpoint")
+        throw Exception("CheckpointHeader", "CheckpointHeader", "not a checkpoint file.");
+
+    readBinary(is, fileVersion);
+
+    if (fileVersion != version)
+        throw Exception("CheckpointHeader", "CheckpointHeader",
+                        "unsupported checkpoint version " + std::to_string(fileVersion) + ".");
+
+    readBinary(is, nProcs);
+    readBinary(is, time);
+    readBinary(is, timeStep);
+}
+
+void CheckpointHeader::write(std::ostream &os) const
+{
+    writeBinary(os, std::string("PhaseCheckpoint"));
+    writeBinary(os, (int) version);
+    writeBinary(os, nProcs);
+    writeBinary(os, time);
+    writeBinary(os, timeStep);
+}
+
+CheckpointRedistribution::CheckpointRedistribution(const Communicator &comm,
+                                                   const std::vector<Label> &readCellIds,
+                                                   const std::vector<Label> &readFaceIds,
+                                                   const std::vector<Label> &readNodeIds,
+                                                   const std::vector<Label> &localCellIds,
+                                                   const std::vector<Label> &localFaceIds,
+                                                   const std::vector<Label> &localNodeIds)
+        :
+        comm_(comm)
+{
+    cells_ = initRoute(readCellIds, localCellIds);
+    faces_ = initRoute(readFaceIds, localFaceIds);
+    nodes_ = initRoute(readNodeIds, localNodeIds);
+}
+
+CheckpointRedistribution::Route CheckpointRedistribution::initRoute(const std::vector<Label> &readIds,
+                                                                    const std::vector<Label> &localIds) const
+{
+    int nProcs = comm_.nProcs();
+
+    //- Read and local ids are sent to the home proc of their serial id
+    std::vector<std::vector<unsigned long>> readBuffers(nProcs), localBuffers(nProcs);
+    std::vector<std::vector<Label>> readInds(nProcs);
+
+    for (Label i = 0; i < readIds.size(); ++i)
+    {
+        readBuffers[readIds[i] % nProcs].push_back(readIds[i]);
+        readInds[readIds[i] % nProcs].push_back(i);
+    }
+
+    for (Label id: localIds)
+        localBuffers[id % nProcs].push_back(id);
+
+    readBuffers = comm_.allToAllv(readBuffers);
+    localBuffers = comm_.allToAllv(localBuffers);
+
+    //- Entities may be in several checkpoints, the first one read is used
+    std::unordered_map<Label, std::pair<int, Label>> sources;
+
+    for (int proc = 0; proc < nProcs; ++proc)
+        for (Label i = 0; i < readBuffers[proc].size(); ++i)
+            sources.insert(std::make_pair(readBuffers[proc][i], std::make_pair(proc, i)));
+
+    //- The readers are told where to send each entry, as (position in the message to the home proc, destination)
+    std::vector<std::vector<unsigned long>> destinations(nProcs);
+
+    for (int proc = 0; proc < nProcs; ++proc)
+        for (Label id: localBuffers[proc])
+        {
+            auto source = sources.find(id);
+
+            if (source == sources.end())
+                throw Exception("CheckpointRedistribution", "initRoute",
+                                "serial id " + std::to_string(id) + " is not in the checkpoint.");
+
+            destinations[source->second.first].push_back(source->second.second);
+            destinations[source->second.first].push_back(proc);
+        }
+
+    destinations = comm_.allToAllv(destinations);
+
+    Route route;
+    route.sendIds.resize(nProcs);
+    route.recvIds.resize(nProcs);
+    route.nRead = readIds.size();
+    route.nLocal = localIds.size();
+
+    std::vector<std::vector<unsigned long>> sendIds(nProcs);
+
+    for (int home = 0; home < nProcs; ++home)
+        for (Label i = 0; i < destinations[home].size(); i += 2)
+        {
+            Label readInd = readInds[home][destinations[home][i]];
+            int proc = destinations[home][i + 1];
+
+            route.sendIds[proc].push_back(readInd);
+            sendIds[proc].push_back(readIds[readInd]);
+        }
+
+    //- The receivers map the serial ids of the entries they will receive to local ids
+    std::vector<std::vector<unsigned long>> recvIds = comm_.allToAllv(sendIds);
+    std::unordered_map<Label, Label> localIdMap;
+
+    for (Label i = 0; i < localIds.size(); ++i)
+        localIdMap[localIds[i]] = i;
+
+    for (int proc = 0; proc < nProcs; ++proc)
+        for (Label id: recvIds[proc])
+            route.recvIds[proc].push_back(localIdMap.at(id));
+
+    return route;
+}
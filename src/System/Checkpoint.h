@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "Communicator.h"
+#include "Exception.h"
+
+//- Header of the per-proc checkpoint files, checkpoint/Proc<proc>.chk
+class CheckpointHeader
+{
+public:
+
+    static const int version = 1;
+
+    static std::string filename(int proc);
+
+    //- Whether a checkpoint has been written, otherwise restarts fall back to the CGNS solution files
+    static bool exists();
+
+    //- Open the checkpoint written by a proc for reading
+    static void open(int proc, std::ifstream &fin);
+
+    CheckpointHeader(int nProcs, Scalar time, Scalar timeStep);
+
+    //- Read and validate a header
+    explicit CheckpointHeader(std::istream &is);
+
+    void write(std::ostream &os) const;
+
+    int nProcs;
+    Scalar time, timeStep;
+};
+
+//- Routes the entries of checkpoints written on another decomposition to the procs holding them. Each proc reads
+//- a slice of the checkpoint files, and the entries are matched to the local entities by serial id
+class CheckpointRedistribution
+{
+public:
+
+    CheckpointRedistribution(const Communicator &comm,
+                             const std::vector<Label> &readCellIds,
+                             const std::vector<Label> &readFaceIds,
+                             const std::vector<Label> &readNodeIds,
+                             const std::vector<Label> &localCellIds,
+                             const std::vector<Label> &localFaceIds,
+                             const std::vector<Label> &localNodeIds);
+
+    const Communicator &comm() const
+    { return comm_; }
+
+    //- Values in local ordering, from the values read by this proc in the order of the read ids
+    template<class T>
+    std::vector<T> cellData(const std::vector<T> &vals) const
+    { return route(vals, cells_); }
+
+    template<class T>
+    std::vector<T> faceData(const std::vector<T> &vals) const
+    { return route(vals, faces_); }
+
+    template<class T>
+    std::vector<T> nodeData(const std::vector<T> &vals) const
+    { return route(vals, nodes_); }
+
+private:
+
+    struct Route
+    {
+        std::vector<std::vector<Label>> sendIds, recvIds;
+        Size nRead, nLocal;
+    };
+
+    //- Match the read ids to the local ids on a home proc, selected by serial id
+    Route initRoute(const std::vector<Label> &readIds, const std::vector<Label> &localIds) const;
+
+    template<class T>
+    std::vector<T> route(const std::vector<T> &vals, const Route &route) const;
+
+    const Communicator &comm_;
+
+    Route cells_, faces_, nodes_;
+};
+
+#include "Checkpoint.tpp"
+
+#endif
@@ -0,0 +1,23 @@
+#include "Checkpoint.h"
+
+template<class T>
+std::vector<T> CheckpointRedistribution::route(const std::vector<T> &vals, const Route &route) const
+{
+    if (vals.size() != route.nRead)
+        throw Exception("CheckpointRedistribution", "route", "checkpoint entries do not match their ids.");
+
+    std::vector<std::vector<T>> sendBuffers(comm_.nProcs());
+
+    for (int proc = 0; proc < comm_.nProcs(); ++proc)
+        for (Label id: route.sendIds[proc])
+            sendBuffers[proc].push_back(vals[id]);
+
+    std::vector<std::vector<T>> recvBuffers = comm_.allToAllv(sendBuffers);
+    std::vector<T> result(route.nLocal);
+
+    for (int proc = 0; proc < comm_.nProcs(); ++proc)
+        for (Label i = 0; i < recvBuffers[proc].size(); ++i)
+            result[route.recvIds[proc][i]] = recvBuffers[proc][i];
+
+    return result;
+}
@@ -55,6 +55,12 @@ std::string CommandLine::getOption(const std::string &option)
     return it->second;
 }
 
+std::string CommandLine::getOption(const std::string &option, const std::string &defaultValue)
+{
+    auto it = parsedArgs_.find(option);
+    return it == parsedArgs_.end() ? defaultValue : it->second;
+}
+
 //- Private
 
 void CommandLine::printHelpMessage(const char programName[])
@@ -17,6 +17,7 @@ public:
     void parseArguments(int argc, char *argv[]);
 
     std::string getOption(const std::string& option);
+    std::string getOption(const std::string& option, const std::string& defaultValue);
 
     int argc() const { return argc_; }
     char** argv() const { return argv_; }
@@ -0,0 +1,93 @@
+#include "LoadBalancer.h"
+
+LoadBalancer::LoadBalancer(const Input &input, const Solver &solver)
+{
+    enabled_ = input.caseInput().get<bool>("System.loadBalancing.enabled", false)
+               && solver.grid().comm().nProcs() > 1
+               && solver.grid().canRepartition();
+
+    frequency_ = input.caseInput().get<size_t>("System.loadBalancing.frequency", 100);
+    threshold_ = input.caseInput().get<Scalar>("System.loadBalancing.threshold", 1.1);
+
+    //- Relative cost of the different cell types
+    fluidCellWeight_ = input.caseInput().get<Scalar>("System.loadBalancing.fluidCellWeight", 1.);
+    ibCellWeight_ = input.caseInput().get<Scalar>("System.loadBalancing.ibCellWeight", 2.);
+    solidCellWeight_ = input.caseInput().get<Scalar>("System.loadBalancing.solidCellWeight", 0.1);
+}
+
+void LoadBalancer::start()
+{
+    time_.start();
+}
+
+void LoadBalancer::stop()
+{
+    time_.stop();
+    solveTime_ += time_.elapsedSeconds();
+}
+
+bool LoadBalancer::balance(const Input &input, Solver &solver, Viewer &viewer, const PostProcessing &postProcessing,
+                           size_t iterNo)
+{
+    if (!enabled_ || iterNo == 0 || iterNo % frequency_ != 0)
+        return false;
+
+    const Communicator &comm = solver.grid().comm();
+
+    std::vector<Scalar> weights = cellWeights(solver);
+
+    Scalar load = 0.;
+    for (const Cell &cell: solver.grid().localActiveCells())
+        load += weights[cell.id()];
+
+    //- Solve times include time spent waiting in collectives, so they are reported but not used to drive the balance
+    Reduction stats(comm);
+    Size maxTimeId = stats.add(solveTime_, Reduction::MAX);
+    Size sumTimeId = stats.add(solveTime_, Reduction::SUM);
+    Size maxLoadId = stats.add(load, Reduction::MAX);
+    Size sumLoadId = stats.add(load, Reduction::SUM);
+    stats.reduce();
+    solveTime_ = 0.;
+
+    Scalar maxTime = stats.scalar(maxTimeId);
+    Scalar meanTime = stats.scalar(sumTimeId) / comm.nProcs();
+    Scalar maxLoad = stats.scalar(maxLoadId);
+    Scalar meanLoad = stats.scalar(sumLoadId) / comm.nProcs();
+    Scalar imbalance = meanLoad > 0. ? maxLoad / meanLoad : 1.;
+
+    solver.printf("Load balance: max/mean solve time = %.2lf/%.2lf s, load imbalance = %.3lf.\n",
+                  maxTime, meanTime, imbalance);
+
+    if (imbalance < threshold_)
+        return false;
+
+    solver.printf("Load imbalance exceeds threshold of %.3lf, repartitioning...\n", threshold_);
+    solver.repartition(input, weights);
+    viewer.updateGrid();
+    postProcessing.updateGrid();
+    solver.printf("Repartitioning complete.\n");
+
+    return true;
+}
+
+std::vector<Scalar> LoadBalancer::cellWeights(const Solver &solver) const
+{
+    const FiniteVolumeField<int> &cellStatus = solver.integerField("cellStatus");
+    std::vector<Scalar> weights(solver.grid().nCells(), fluidCellWeight_);
+
+    for (const Cell &cell: solver.grid().cells())
+        switch (cellStatus(cell))
+        {
+            case ImmersedBoundary::IB_CELLS:
+                weights[cell.id()] = ibCellWeight_;
+                break;
+            case ImmersedBoundary::SOLID_CELLS:
+            case ImmersedBoundary::DEAD_CELLS:
+                weights[cell.id()] = solidCellWeight_;
+                break;
+            default:
+                break;
+        }
+
+    return weights;
+}
@@ -0,0 +1,37 @@
+#ifndef LOAD_BALANCER_H
+#define LOAD_BALANCER_H
+
+#include "Input.h"
+#include "Solver.h"
+#include "Viewer.h"
+#include "PostProcessing.h"
+#include "Time.h"
+
+class LoadBalancer
+{
+public:
+
+    LoadBalancer(const Input &input, const Solver &solver);
+
+    //- Time the solution step on this proc
+    void start();
+
+    void stop();
+
+    //- Repartition the grid if the imbalance has exceeded the threshold. Returns true if repartitioned
+    bool balance(const Input &input, Solver &solver, Viewer &viewer, const PostProcessing &postProcessing,
+                 size_t iterNo);
+
+    std::vector<Scalar> cellWeights(const Solver &solver) const;
+
+private:
+
+    bool enabled_;
+    size_t frequency_;
+    Scalar threshold_, fluidCellWeight_, ibCellWeight_, solidCellWeight_;
+
+    Time time_;
+    Scalar solveTime_ = 0.;
+};
+
+#endif
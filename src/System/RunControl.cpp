@@ -1,5 +1,6 @@
 #include "RunControl.h"
 #include "PostProcessing.h"
+#include "LoadBalancer.h"
 
 void RunControl::run(const Input &input, Solver &solver, Viewer &viewer)
 {
@@ -12,23 +13,30 @@ void RunControl::run(const Input &input, Solver &solver, Viewer &viewer)
 
     //- Time
     Scalar time = solver.getStartTime(input);
-    Scalar timeStep = input.caseInput().get<Scalar>("Solver.initialTimeStep", solver.maxTimeStep());
+    Scalar timeStep = solver.getStartTimeStep(input);
 
     //- Write control
     size_t fileWriteFrequency = input.caseInput().get<size_t>("System.fileWriteFrequency"), iterNo;
 
+    //- Checkpoint control, wall clock minutes between checkpoints (disabled by default)
+    Scalar checkpointInterval = input.caseInput().get<Scalar>("System.checkpointInterval", 0.) * 60;
+    Scalar lastCheckpoint = 0.;
+
     //- Print the solver info
     solver.printf("%s\n", (std::string(96, '-')).c_str());
     solver.printf("%s", solver.info().c_str());
     solver.printf("%s\n", (std::string(96, '-')).c_str());
 
+    //- Post-processing, before the initial conditions so that fields it adds are read from a checkpoint
+    PostProcessing postProcessing(input, solver, viewer);
+
     //- Initial conditions
     solver.setInitialConditions(input);
     solver.initialize();
     solver.printf("Starting simulation time: %.2lf s\n", time);
 
-    //- Post-processing
-    PostProcessing postProcessing(input, solver);
+    //- Dynamic load balancing
+    LoadBalancer loadBalancer(input, solver);
 
     time_.start();
     for (
@@ -50,7 +58,20 @@ void RunControl::run(const Input &input, Solver &solver, Viewer &viewer)
             //  viewer.write(solver.volumeIntegrators());
         }
 
+        if (checkpointInterval > 0. && iterNo > 0
+            && time_.elapsedSeconds(solver.grid().comm()) - lastCheckpoint >= checkpointInterval)
+        {
+            solver.writeCheckpoint(time, timeStep);
+            lastCheckpoint = time_.elapsedSeconds(solver.grid().comm());
+            solver.printf("Checkpoint written at simulation time %.2lf s.\n", time);
+        }
+
+        loadBalancer.balance(input, solver, viewer, postProcessing, iterNo);
+
+        loadBalancer.start();
         solver.solve(timeStep);
+        loadBalancer.stop();
+
         postProcessing.compute(time + timeStep);
 
         time_.stop();
@@ -64,6 +85,11 @@ void RunControl::run(const Input &input, Solver &solver, Viewer &viewer)
     time_.stop();
 
     viewer.write(time);
+    viewer.flush();
+
+    if (checkpointInterval > 0.)
+        solver.writeCheckpoint(time, timeStep);
+
     solver.printf("%s\n", (std::string(96, '*')).c_str());
     solver.printf("Calculation complete.\n");
     solver.printf("Elapsed time: %s\n", time_.elapsedTime().c_str());
@@ -0,0 +1,56 @@
+#include "AsyncViewer.h"
+
+AsyncViewer::AsyncViewer(const Input &input, const Solver &solver, const std::shared_ptr<Viewer> &viewer)
+        :
+        Viewer(input, solver),
+        viewer_(viewer)
+{
+
+}
+
+AsyncViewer::~AsyncViewer()
+{
+    if (pendingWrite_.valid())
+        pendingWrite_.wait();
+}
+
+void AsyncViewer::write(Scalar solutionTime)
+{
+    //- Fill the free buffer while the previous snapshot may still be writing
+    Snapshot &buffer = buffers_[currentBuffer_];
+    viewer_->snapshot(solutionTime, buffer);
+
+    flush();
+
+    pendingWrite_ = std::async(std::launch::async, [this, &buffer]() { viewer_->write(buffer); });
+    currentBuffer_ = 1 - currentBuffer_;
+}
+
+void AsyncViewer::write(const Snapshot &snapshot)
+{
+    flush();
+    viewer_->write(snapshot);
+}
+
+void AsyncViewer::flush()
+{
+    //- Rethrows any exception raised by the background write
+    if (pendingWrite_.valid())
+        pendingWrite_.get();
+}
+
+void AsyncViewer::updateGrid()
+{
+    flush();
+    viewer_->updateGrid();
+}
+
+void AsyncViewer::addField(const ScalarFiniteVolumeField &field)
+{
+    viewer_->addField(field);
+}
+
+void AsyncViewer::addField(const VectorFiniteVolumeField &field)
+{
+    viewer_->addField(field);
+}
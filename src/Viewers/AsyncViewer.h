@@ -0,0 +1,40 @@
+#ifndef ASYNC_VIEWER_H
+#define ASYNC_VIEWER_H
+
+#include <future>
+
+#include "Viewer.h"
+
+//- Writes output on a background thread. Field data is copied into one of two snapshot buffers and the solver
+//- continues while the other buffer is being written. A write blocks only if the previous one is still in flight
+class AsyncViewer : public Viewer
+{
+public:
+
+    AsyncViewer(const Input &input, const Solver &solver, const std::shared_ptr<Viewer> &viewer);
+
+    ~AsyncViewer();
+
+    void write(Scalar solutionTime);
+
+    void write(const Snapshot &snapshot);
+
+    void flush();
+
+    void updateGrid();
+
+    void addField(const ScalarFiniteVolumeField &field);
+
+    void addField(const VectorFiniteVolumeField &field);
+
+protected:
+
+    std::shared_ptr<Viewer> viewer_;
+
+    Snapshot buffers_[2];
+    int currentBuffer_ = 0;
+
+    std::future<void> pendingWrite_;
+};
+
+#endif
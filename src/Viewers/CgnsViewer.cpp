@@ -2,6 +2,8 @@
 #include <iomanip>
 #include <stdio.h>
 
+#include <numeric>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <cgnslib.h>
@@ -22,79 +24,246 @@ CgnsViewer::CgnsViewer(const Input &input, const Solver &solver)
 
     gridfile_ = filename;
 
+    //- On restart, solutions written before may link to a grid of a different decomposition
+    if (boost::filesystem::exists(gridfile_))
+        archiveGrid(linkedSolutionFiles());
+
+    writeGrid();
+}
+
+void CgnsViewer::write(const Snapshot &snapshot)
+{
+    char filename[256];
+    sprintf(filename, "solution/%lf/Proc%d", snapshot.time, snapshot.rank);
+
+    boost::filesystem::create_directories(filename);
+
+    sprintf(filename, "solution/%lf/Proc%d/Solution.cgns", snapshot.time, snapshot.rank);
+
     int fid, bid, zid, sid;
+
     cg_open(filename, CG_MODE_WRITE, &fid);
+
     bid = createBase(fid, filename_);
     zid = createZone(fid, bid, solver_.grid(), "Cells");
-    writeCoords(fid, bid, zid, solver_.grid());
-    writeConnectivity(fid, bid, zid, solver_.grid());
-    writeBoundaryConnectivity(fid, bid, zid, solver_.grid());
-    //writeImmersedBoundaries(fid, solver_);
 
-    //- Write data necessary to reuse partitioned grid
-    cg_sol_write(fid, bid, zid, "Info", CGNS_ENUMV(CellCenter), &sid);
+    char gridfile[256];
+    sprintf(gridfile, "../../Proc%d/Grid.cgns", snapshot.rank);
+    linkGrid(fid, bid, zid, gridfile, gridPatches_);
 
-    std::vector<int> procNo(solver.grid().cells().size(), solver.grid().comm().rank());
-    if (!solver.grid().bufferZones().empty())
-        for (int proc = 0; proc < solver.grid().comm().nProcs(); ++proc)
-            for (const Cell &cell: solver.grid().bufferZones()[proc])
-                procNo[cell.id()] = proc;
+    cg_sol_write(fid, bid, zid, "Solution", CGNS_ENUMV(CellCenter), &sid);
 
     int fieldId;
-    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "ProcNo", procNo.data(), &fieldId);
 
-    std::vector<int> globalId(solver.grid().cells().size(), -1);
-    std::vector<int> globalIdStart(1, 0);
-    CellGroup localCells = solver.grid().localActiveCells() + solver.grid().localInactiveCells();
-    for (int size: solver.grid().comm().allGather(localCells.size()))
-        globalIdStart.push_back(globalIdStart.back() + size);
+    for (const auto &field: snapshot.integerFields)
+        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), field.first.c_str(), field.second.data(), &fieldId);
 
-    int id = globalIdStart[solver.grid().comm().rank()];
-    for (const Cell &cell: localCells)
-        globalId[cell.id()] = id++;
+    for (const auto &field: snapshot.scalarFields)
+        writeField(fid, bid, zid, sid, field.first, field.second, singlePrecision(field.first));
+
+    for (const auto &field: snapshot.vectorFields)
+    {
+        std::vector<Scalar> x(field.second.size()), y(field.second.size());
+        std::transform(field.second.begin(), field.second.end(), x.begin(), [](const Vector2D &vec) { return vec.x; });
+        std::transform(field.second.begin(), field.second.end(), y.begin(), [](const Vector2D &vec) { return vec.y; });
+
+        writeField(fid, bid, zid, sid, field.first + "X", x, singlePrecision(field.first));
+        writeField(fid, bid, zid, sid, field.first + "Y", y, singlePrecision(field.first));
+    }
 
-    solver.grid().sendMessages(globalId);
-    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "GlobalID", globalId.data(), &fieldId);
     cg_close(fid);
+
+    solutionFiles_.push_back(filename);
 }
 
-void CgnsViewer::write(Scalar solutionTime)
+void CgnsViewer::writeField(int fid, int bid, int zid, int sid, const std::string &name,
+                            const std::vector<Scalar> &vals, bool singlePrecision)
 {
-    char filename[256];
-    sprintf(filename, "solution/%lf/Proc%d", solutionTime, solver_.grid().comm().rank());
+    int fieldId;
 
-    boost::filesystem::create_directories(filename);
+    if (singlePrecision)
+    {
+        std::vector<float> fvals(vals.begin(), vals.end());
+        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(RealSingle), name.c_str(), fvals.data(), &fieldId);
+    }
+    else
+        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(RealDouble), name.c_str(), vals.data(), &fieldId);
+}
 
-    sprintf(filename, "solution/%lf/Proc%d/Solution.cgns", solutionTime, solver_.grid().comm().rank());
+void CgnsViewer::updateGrid()
+{
+    archiveGrid(solutionFiles_);
+    solutionFiles_.clear();
+    writeGrid();
+}
 
-    int fid, bid, zid, sid;
+//- Protected
 
-    cg_open(filename, CG_MODE_WRITE, &fid);
+void CgnsViewer::archiveGrid(const std::vector<std::string> &solutionFiles)
+{
+    //- Solutions written on the previous partition are relinked to an archived copy of its grid. Archives of
+    //- earlier runs are kept
+    char filename[256], linkname[256];
+    int rank = solver_.grid().comm().rank();
+
+    do
+        sprintf(filename, "solution/Proc%d/Grid%d.cgns", rank, nArchivedGrids_++);
+    while (boost::filesystem::exists(filename));
+
+    sprintf(linkname, "../../Proc%d/Grid%d.cgns", rank, nArchivedGrids_ - 1);
+
+    boost::filesystem::rename(gridfile_, filename);
+
+    //- The patches written on a proc depend on the partition, so they are read from the archived grid
+    std::vector<std::string> patches;
+    int fid, nSections;
+    cg_open(filename, CG_MODE_READ, &fid);
+    cg_nsections(fid, 1, 1, &nSections);
+
+    for (int sec = 1; sec <= nSections; ++sec)
+    {
+        char name[33];
+        CGNS_ENUMT(ElementType_t) type;
+        cgsize_t start, end;
+        int nBoundary, parentFlag;
+        cg_section_read(fid, 1, 1, sec, name, &type, &start, &end, &nBoundary, &parentFlag);
+
+        std::string section = name;
+
+        if (section != "GridElements")
+            patches.push_back(section.substr(0, section.size() - std::string("Elements").size()));
+    }
+
+    cg_close(fid);
+
+    for (const std::string &solutionFile: solutionFiles)
+    {
+        cg_open(solutionFile.c_str(), CG_MODE_MODIFY, &fid);
+        cg_goto(fid, 1, "Zone_t", 1, "end");
+
+        cg_delete_node("GridCoordinates");
+        cg_delete_node("GridElements");
+
+        if (!patches.empty())
+            cg_delete_node("ZoneBC");
 
+        for (const std::string &patch: patches)
+            cg_delete_node((patch + "Elements").c_str());
+
+        linkGrid(fid, 1, 1, linkname, patches);
+        cg_close(fid);
+    }
+}
+
+std::vector<std::string> CgnsViewer::linkedSolutionFiles() const
+{
+    //- Solutions of this proc whose grid is linked to the current grid file
+    using namespace boost::filesystem;
+
+    char linkname[256];
+    sprintf(linkname, "../../Proc%d/Grid.cgns", solver_.grid().comm().rank());
+
+    std::vector<std::string> files;
+
+    for (directory_iterator end, dir("solution"); dir != end; ++dir)
+    {
+        path file = dir->path() / ("Proc" + std::to_string(solver_.grid().comm().rank())) / "Solution.cgns";
+
+        if (!exists(file))
+            continue;
+
+        int fid, isLink = 0;
+        cg_open(file.c_str(), CG_MODE_READ, &fid);
+
+        if (cg_goto(fid, 1, "Zone_t", 1, "GridCoordinates_t", 1, "end") == CG_OK && cg_is_link(&isLink) == CG_OK
+            && isLink)
+        {
+            char *linkfile, *linkpath;
+            cg_link_read(&linkfile, &linkpath);
+
+            if (std::string(linkfile) == linkname)
+                files.push_back(file.string());
+
+            cg_free(linkfile);
+            cg_free(linkpath);
+        }
+
+        cg_close(fid);
+    }
+
+    return files;
+}
+
+void CgnsViewer::writeGrid()
+{
+    int fid, bid, zid, sid;
+    cg_open(gridfile_.c_str(), CG_MODE_WRITE, &fid);
     bid = createBase(fid, filename_);
     zid = createZone(fid, bid, solver_.grid(), "Cells");
-    linkGrid(fid, bid, zid, solver_.grid().comm());
+    writeCoords(fid, bid, zid, solver_.grid());
+    writeConnectivity(fid, bid, zid, solver_.grid());
+    writeBoundaryConnectivity(fid, bid, zid, solver_.grid());
+    //writeImmersedBoundaries(fid, solver_);
 
-    cg_sol_write(fid, bid, zid, "Solution", CGNS_ENUMV(CellCenter), &sid);
+    //- Write data necessary to reuse partitioned grid
+    cg_sol_write(fid, bid, zid, "Info", CGNS_ENUMV(CellCenter), &sid);
+
+    std::vector<int> procNo(solver_.grid().cells().size(), solver_.grid().comm().rank());
+    if (!solver_.grid().bufferZones().empty())
+        for (int proc = 0; proc < solver_.grid().comm().nProcs(); ++proc)
+            for (const Cell &cell: solver_.grid().bufferZones()[proc])
+                procNo[cell.id()] = proc;
 
     int fieldId;
+    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "ProcNo", procNo.data(), &fieldId);
 
-    for (const FiniteVolumeField<int> &field: integerFields_)
-        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), field.name().c_str(), field.data(), &fieldId);
+    //- Serial cell ids, so that the data can be mapped between decompositions
+    std::vector<int> globalId(solver_.grid().cells().size(), -1);
 
-    for (const ScalarFiniteVolumeField &field: scalarFields_)
-        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(RealDouble), field.name().c_str(), field.data(), &fieldId);
+    if (solver_.grid().globalCellIds().empty())
+        std::iota(globalId.begin(), globalId.end(), 0);
+    else
+        std::copy(solver_.grid().globalCellIds().begin(), solver_.grid().globalCellIds().end(), globalId.begin());
 
-    for (const VectorFiniteVolumeField &field: vectorFields_)
-    {
-        std::vector<Scalar> x(field.grid().nCells()), y(field.grid().nCells());
-        std::transform(field.begin(), field.end(), x.begin(), [](const Vector2D &vec) { return vec.x; });
-        std::transform(field.begin(), field.end(), y.begin(), [](const Vector2D &vec) { return vec.y; });
+    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "GlobalID", globalId.data(), &fieldId);
+
+    //- Serial node and face ids, the faces are given by their local node pairs
+    const FiniteVolumeGrid2D &grid = solver_.grid();
+    std::vector<int> nodeIds(grid.nodes().size()), faceNodeIds, faceIds(grid.faces().size());
+    int nSerialFaces = grid.globalFaceIds().empty() ? grid.nFaces() : grid.nSerialFaces();
 
-        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(RealDouble), (field.name() + "X").c_str(), x.data(), &fieldId);
-        cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(RealDouble), (field.name() + "Y").c_str(), y.data(), &fieldId);
+    if (grid.globalNodeIds().empty())
+        std::iota(nodeIds.begin(), nodeIds.end(), 0);
+    else
+        std::copy(grid.globalNodeIds().begin(), grid.globalNodeIds().end(), nodeIds.begin());
+
+    if (grid.globalFaceIds().empty())
+        std::iota(faceIds.begin(), faceIds.end(), 0);
+    else
+        std::copy(grid.globalFaceIds().begin(), grid.globalFaceIds().end(), faceIds.begin());
+
+    for (const Face &face: grid.faces())
+    {
+        faceNodeIds.push_back(face.lNode().id());
+        faceNodeIds.push_back(face.rNode().id());
     }
 
+    cg_goto(fid, bid, "Zone_t", zid, "end");
+    cg_user_data_write("SerialIds");
+    cg_goto(fid, bid, "Zone_t", zid, "SerialIds", 0, "end");
+
+    cgsize_t size = nodeIds.size();
+    cg_array_write("Nodes", CGNS_ENUMV(Integer), 1, &size, nodeIds.data());
+
+    size = faceNodeIds.size();
+    cg_array_write("FaceNodes", CGNS_ENUMV(Integer), 1, &size, faceNodeIds.data());
+
+    size = faceIds.size();
+    cg_array_write("Faces", CGNS_ENUMV(Integer), 1, &size, faceIds.data());
+
+    size = 1;
+    cg_array_write("NSerialFaces", CGNS_ENUMV(Integer), 1, &size, &nSerialFaces);
+
     cg_close(fid);
 }
 
@@ -164,8 +333,14 @@ void CgnsViewer::writeBoundaryConnectivity(int fid, int bid, int zid, const Fini
 {
     //- Now write the boundary mesh elements
     cgsize_t start = grid.nCells() + 1;
+    gridPatches_.clear();
+
     for (const Patch &patch: grid.patches())
     {
+        if (patch.empty()) //- Patches may be empty on some procs
+            continue;
+
+        gridPatches_.push_back(patch.name());
         cgsize_t end = start + patch.size() - 1;
         std::vector<cgsize_t> connectivity;
 
@@ -230,22 +405,17 @@ void CgnsViewer::writeImmersedBoundaries(int fid, const Solver &solver)
     }
 }
 
-void CgnsViewer::linkGrid(int fid, int bid, int zid, const Communicator &comm)
+void CgnsViewer::linkGrid(int fid, int bid, int zid, const std::string &gridfile,
+                          const std::vector<std::string> &patches)
 {
-    char filename[256];
-
-    sprintf(filename, "../../Proc%d/Grid.cgns", comm.rank());
-
     cg_goto(fid, bid, "Zone_t", zid, "end");
-    cg_link_write("GridCoordinates", filename, ("/" + filename_ + "/Cells/GridCoordinates").c_str());
-    cg_link_write("GridElements", filename, ("/" + filename_ + "/Cells/GridElements").c_str());
+    cg_link_write("GridCoordinates", gridfile.c_str(), ("/" + filename_ + "/Cells/GridCoordinates").c_str());
+    cg_link_write("GridElements", gridfile.c_str(), ("/" + filename_ + "/Cells/GridElements").c_str());
 
-    if (!solver_.grid().patches().empty())
-        cg_link_write("ZoneBC", filename, ("/" + filename_ + "/Cells/ZoneBC").c_str());
+    if (!patches.empty())
+        cg_link_write("ZoneBC", gridfile.c_str(), ("/" + filename_ + "/Cells/ZoneBC").c_str());
 
-    for (const Patch &patch: solver_.grid().patches())
-    {
-        std::string name(patch.name());
-        cg_link_write((name + "Elements").c_str(), filename, ("/" + filename_ + "/Cells/" + name + "Elements").c_str());
-    }
+    for (const std::string &patch: patches)
+        cg_link_write((patch + "Elements").c_str(), gridfile.c_str(),
+                      ("/" + filename_ + "/Cells/" + patch + "Elements").c_str());
 }
@@ -11,10 +11,21 @@ public:
 
     CgnsViewer(const Input& input, const Solver& solver);
 
-    void write(Scalar solutionTime);
+    using Viewer::write;
+
+    void write(const Snapshot &snapshot);
+
+    void updateGrid();
 
 protected:
 
+    //- Move the grid file to an archive and relink the given solutions to it
+    void archiveGrid(const std::vector<std::string> &solutionFiles);
+
+    std::vector<std::string> linkedSolutionFiles() const;
+
+    void writeGrid();
+
     int  createBase(int fid, const std::string& name = "Case");
     int  createZone(int fid, int bid, const FiniteVolumeGrid2D& grid, const std::string& name = "Cells");
 
@@ -23,9 +34,15 @@ protected:
     void writeBoundaryConnectivity(int fid, int bid, int zid, const FiniteVolumeGrid2D& grid);
     void writeImmersedBoundaries(int fid, const Solver& solver);
 
-    void linkGrid(int fid, int bid, int zid, const Communicator &comm);
+    void linkGrid(int fid, int bid, int zid, const std::string &gridfile, const std::vector<std::string> &patches);
+
+    //- Write a real valued field, converted to single precision if requested
+    void writeField(int fid, int bid, int zid, int sid, const std::string &name, const std::vector<Scalar> &vals,
+                    bool singlePrecision);
 
     std::string gridfile_;
+    std::vector<std::string> gridPatches_, solutionFiles_;
+    int nArchivedGrids_ = 0;
 };
 
 #endif
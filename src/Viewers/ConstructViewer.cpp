@@ -0,0 +1,34 @@
+#include "ConstructViewer.h"
+#include "CgnsViewer.h"
+#ifdef PHASE_HDF5_VIEWER
+#include "Hdf5Viewer.h"
+#endif
+#include "AsyncViewer.h"
+#include "Exception.h"
+
+std::shared_ptr<Viewer> constructViewer(const Input &input, const Solver &solver)
+{
+    std::string type = input.caseInput().get<std::string>("Viewer.type", "cgns");
+    bool async = input.caseInput().get<bool>("Viewer.async", false);
+
+    std::shared_ptr<Viewer> viewer;
+
+    if (type == "cgns")
+        viewer = std::make_shared<CgnsViewer>(input, solver);
+    else if (type == "hdf5")
+#ifdef PHASE_HDF5_VIEWER
+        viewer = std::make_shared<Hdf5Viewer>(input, solver);
+#else
+        throw Exception("", "constructViewer", "viewer type \"hdf5\" requires HDF5 with parallel support.");
+#endif
+    else
+        throw Exception("", "constructViewer", "invalid viewer type \"" + type + "\".");
+
+    if (async && !viewer->asyncSafe())
+        solver.printf("Viewer \"%s\" cannot write asynchronously with the available MPI thread support, writing synchronously.\n",
+                      type.c_str());
+    else if (async)
+        return std::make_shared<AsyncViewer>(input, solver, viewer);
+
+    return viewer;
+}
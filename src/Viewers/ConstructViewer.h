@@ -0,0 +1,11 @@
+#ifndef CONSTRUCT_VIEWER_H
+#define CONSTRUCT_VIEWER_H
+
+#include <memory>
+
+#include "Input.h"
+#include "Viewer.h"
+
+std::shared_ptr<Viewer> constructViewer(const Input &input, const Solver &solver);
+
+#endif
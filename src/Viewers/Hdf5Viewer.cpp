@@ -0,0 +1,391 @@
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "Hdf5Viewer.h"
+#include "Exception.h"
+
+Hdf5Viewer::Hdf5Viewer(const Input &input, const Solver &solver)
+        :
+        Viewer(input, solver),
+        comm_(solver.grid().comm().duplicate())
+{
+    if (solver.grid().comm().isMainProc())
+        boost::filesystem::create_directories("solution");
+
+    solver.grid().comm().barrier();
+
+    deflateLevel_ = input.caseInput().get<int>("Viewer.compression.deflate", 0);
+    shuffle_ = input.caseInput().get<bool>("Viewer.compression.shuffle", false);
+    zfpAccuracy_ = input.caseInput().get<Scalar>("Viewer.compression.zfpAccuracy", 0.);
+
+    if (deflateLevel_ < 0 || deflateLevel_ > 9)
+        throw Exception("Hdf5Viewer", "Hdf5Viewer", "deflate level must be between 0 and 9.");
+
+    if (zfpAccuracy_ > 0. && H5Zfilter_avail(zfpFilter_) <= 0)
+    {
+        solver.printf("ZFP filter plugin not available, writing without lossy compression.\n");
+        zfpAccuracy_ = 0.;
+    }
+
+    if (solver.grid().comm().isMainProc())
+        readXdmf();
+
+    initGrid();
+}
+
+void Hdf5Viewer::write(const Snapshot &snapshot)
+{
+    const Communicator &comm = *comm_;
+
+    char dir[256];
+    sprintf(dir, "solution/%lf", snapshot.time);
+
+    if (comm.isMainProc())
+        boost::filesystem::create_directories(dir);
+
+    comm.barrier();
+
+    if (gridfile_.empty())
+        writeGrid(dir);
+
+    hid_t fid = createFile(std::string(dir) + "/Solution.h5");
+
+    for (const auto &field: snapshot.integerFields)
+    {
+        std::vector<int> vals(ownedCells_.size());
+        std::transform(ownedCells_.begin(), ownedCells_.end(), vals.begin(), [&field](Label id) { return field.second[id]; });
+        writeDataset(fid, field.first, vals, cellRows_, nCellsGlobal_, 1, H5T_NATIVE_INT, H5T_NATIVE_INT);
+    }
+
+    for (const auto &field: snapshot.scalarFields)
+    {
+        std::vector<Scalar> vals(ownedCells_.size());
+        std::transform(ownedCells_.begin(), ownedCells_.end(), vals.begin(), [&field](Label id) { return field.second[id]; });
+        writeDataset(fid, field.first, vals, cellRows_, nCellsGlobal_, 1, H5T_NATIVE_DOUBLE,
+                     singlePrecision(field.first) ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE, true);
+    }
+
+    for (const auto &field: snapshot.vectorFields)
+    {
+        std::vector<Scalar> vals;
+        vals.reserve(2 * ownedCells_.size());
+
+        for (Label id: ownedCells_)
+        {
+            vals.push_back(field.second[id].x);
+            vals.push_back(field.second[id].y);
+        }
+
+        writeDataset(fid, field.first, vals, cellRows_, nCellsGlobal_, 2, H5T_NATIVE_DOUBLE,
+                     singlePrecision(field.first) ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE, true);
+    }
+
+    H5Fclose(fid);
+
+    if (comm.isMainProc())
+        writeXdmf(snapshot.time, dir);
+}
+
+bool Hdf5Viewer::asyncSafe() const
+{
+    //- Writes are collective, so they can only be issued off the main thread with full MPI thread support
+    return Communicator::threadSupport() == MPI_THREAD_MULTIPLE;
+}
+
+void Hdf5Viewer::updateGrid()
+{
+    //- Rows follow the serial ids, so the written grid remains valid and only the owned rows change
+    initGrid();
+}
+
+//- Protected methods
+
+void Hdf5Viewer::initGrid()
+{
+    const FiniteVolumeGrid2D &grid = solver_.grid();
+    const Communicator &comm = grid.comm();
+
+    if (comm.nProcs() > 1 && (grid.globalCellIds().size() != grid.cells().size()
+                              || grid.globalNodeIds().size() != grid.nodes().size()))
+        throw Exception("Hdf5Viewer", "initGrid", "the serial ids are required to write a decomposed grid.");
+
+    auto cellId = [&grid](Label id) { return grid.globalCellIds().empty() ? id : grid.globalCellIds()[id]; };
+    auto nodeId = [&grid](Label id) { return grid.globalNodeIds().empty() ? id : grid.globalNodeIds()[id]; };
+
+    ownedCells_.clear();
+
+    for (const CellZone &zone: {std::cref(grid.localActiveCells()), std::cref(grid.localInactiveCells())})
+        for (const Cell &cell: zone)
+            ownedCells_.push_back(cell.id());
+
+    //- Rows are the serial ids, selected in increasing order so that memory and file order match
+    std::sort(ownedCells_.begin(), ownedCells_.end(), [&cellId](Label lhs, Label rhs)
+    { return cellId(lhs) < cellId(rhs); });
+
+    cellRows_.resize(ownedCells_.size());
+    std::transform(ownedCells_.begin(), ownedCells_.end(), cellRows_.begin(), cellId);
+    nCellsGlobal_ = comm.sum((unsigned long) ownedCells_.size());
+
+    //- A node is owned by the lowest ranked proc owning one of its cells. Buffers include the diagonal cells,
+    //  so all cells of the nodes of owned cells are available locally
+    std::vector<int> cellOwner(grid.cells().size(), comm.rank());
+    for (int proc = 0; proc < grid.bufferZones().size(); ++proc)
+        for (const Cell &cell: grid.bufferZones()[proc])
+            cellOwner[cell.id()] = proc;
+
+    std::vector<bool> visited(grid.nodes().size(), false);
+    std::vector<Label> ownedNodes;
+
+    for (Label id: ownedCells_)
+        for (const Node &node: grid.cells()[id].nodes())
+        {
+            if (visited[node.id()])
+                continue;
+
+            visited[node.id()] = true;
+
+            int owner = comm.rank();
+            for (const Cell &cell: node.cells())
+                owner = std::min(owner, cellOwner[cell.id()]);
+
+            if (owner == comm.rank())
+                ownedNodes.push_back(node.id());
+        }
+
+    std::sort(ownedNodes.begin(), ownedNodes.end(), [&nodeId](Label lhs, Label rhs)
+    { return nodeId(lhs) < nodeId(rhs); });
+
+    nodeRows_.resize(ownedNodes.size());
+    std::transform(ownedNodes.begin(), ownedNodes.end(), nodeRows_.begin(), nodeId);
+    nNodesGlobal_ = comm.sum((unsigned long) ownedNodes.size());
+
+    gridNodes_.clear();
+    gridNodes_.reserve(2 * ownedNodes.size());
+
+    for (Label id: ownedNodes)
+    {
+        gridNodes_.push_back(grid.nodes()[id].x);
+        gridNodes_.push_back(grid.nodes()[id].y);
+    }
+
+    int maxNodesPerCell = 0;
+    for (Label id: ownedCells_)
+        maxNodesPerCell = std::max(maxNodesPerCell, (int) grid.cells()[id].nodes().size());
+
+    nodesPerCell_ = comm.max(maxNodesPerCell);
+
+    //- Cells with fewer nodes repeat their last node
+    gridCells_.clear();
+    gridCells_.reserve(nodesPerCell_ * ownedCells_.size());
+
+    for (Label id: ownedCells_)
+    {
+        const Cell &cell = grid.cells()[id];
+
+        for (int j = 0; j < nodesPerCell_; ++j)
+        {
+            const Node &node = cell.nodes()[std::min(j, (int) cell.nodes().size() - 1)];
+            gridCells_.push_back(nodeId(node.id()));
+        }
+    }
+}
+
+void Hdf5Viewer::writeGrid(const std::string &dir)
+{
+    hid_t fid = createFile(dir + "/Grid.h5");
+    writeDataset(fid, "Nodes", gridNodes_, nodeRows_, nNodesGlobal_, 2, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE);
+    writeDataset(fid, "Cells", gridCells_, cellRows_, nCellsGlobal_, nodesPerCell_, H5T_NATIVE_ULONG,
+                 H5T_NATIVE_ULONG);
+    H5Fclose(fid);
+
+    gridfile_ = dir.substr(std::string("solution/").size()) + "/Grid.h5";
+}
+
+std::string Hdf5Viewer::xdmfGrid(Scalar solutionTime, const std::string &gridfile, const std::string &solutionfile) const
+{
+    std::ostringstream sout;
+    Size nCells = nCellsGlobal_;
+
+    sout << "    <Grid Name=\"" << filename_ << "\" GridType=\"Uniform\">\n"
+         << "      <Time Value=\"" << solutionTime << "\"/>\n"
+         << "      <Topology TopologyType=\"Polygon\" NodesPerElement=\"" << nodesPerCell_
+         << "\" NumberOfElements=\"" << nCells << "\">\n"
+         << "        <DataItem Dimensions=\"" << nCells << " " << nodesPerCell_
+         << "\" NumberType=\"UInt\" Precision=\"8\" Format=\"HDF\">" << gridfile << ":/Cells</DataItem>\n"
+         << "      </Topology>\n"
+         << "      <Geometry GeometryType=\"XY\">\n"
+         << "        <DataItem Dimensions=\"" << nNodesGlobal_
+         << " 2\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">" << gridfile << ":/Nodes</DataItem>\n"
+         << "      </Geometry>\n";
+
+    for (const FiniteVolumeField<int> &field: integerFields_)
+        sout << "      <Attribute Name=\"" << field.name() << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n"
+             << "        <DataItem Dimensions=\"" << nCells << "\" NumberType=\"Int\" Precision=\"4\" Format=\"HDF\">"
+             << solutionfile << ":/" << field.name() << "</DataItem>\n"
+             << "      </Attribute>\n";
+
+    for (const ScalarFiniteVolumeField &field: scalarFields_)
+        sout << "      <Attribute Name=\"" << field.name() << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n"
+             << "        <DataItem Dimensions=\"" << nCells << "\" NumberType=\"Float\" Precision=\""
+             << (singlePrecision(field.name()) ? 4 : 8) << "\" Format=\"HDF\">"
+             << solutionfile << ":/" << field.name() << "</DataItem>\n"
+             << "      </Attribute>\n";
+
+    for (const VectorFiniteVolumeField &field: vectorFields_)
+        sout << "      <Attribute Name=\"" << field.name() << "\" AttributeType=\"Vector\" Center=\"Cell\">\n"
+             << "        <DataItem Dimensions=\"" << nCells << " 2\" NumberType=\"Float\" Precision=\""
+             << (singlePrecision(field.name()) ? 4 : 8) << "\" Format=\"HDF\">"
+             << solutionfile << ":/" << field.name() << "</DataItem>\n"
+             << "      </Attribute>\n";
+
+    sout << "    </Grid>\n";
+
+    return sout.str();
+}
+
+void Hdf5Viewer::readXdmf()
+{
+    //- Restarted runs extend the time series, entries are replaced once the new run writes their time
+    std::ifstream fin("solution/Solution.xmf");
+    std::string line, grid;
+    Scalar time = 0.;
+
+    while (std::getline(fin, line))
+    {
+        if (line.compare(0, 10, "    <Grid ") == 0)
+            grid.clear();
+
+        grid += line + "\n";
+
+        if (line.compare(0, 19, "      <Time Value=\"") == 0)
+            time = std::stod(line.substr(19));
+        else if (line == "    </Grid>")
+            series_.push_back(std::make_pair(time, grid));
+    }
+}
+
+void Hdf5Viewer::writeXdmf(Scalar solutionTime, const std::string &dir)
+{
+    std::ofstream fout(dir + "/Solution.xmf");
+    fout << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"3.0\">\n"
+         << "  <Domain>\n"
+         << xdmfGrid(solutionTime, "../" + gridfile_, "Solution.h5")
+         << "  </Domain>\n"
+         << "</Xdmf>\n";
+    fout.close();
+
+    series_.erase(std::remove_if(series_.begin(), series_.end(),
+                                 [solutionTime](const std::pair<Scalar, std::string> &entry)
+                                 { return entry.first >= solutionTime; }), series_.end());
+
+    series_.push_back(std::make_pair(solutionTime, xdmfGrid(solutionTime, gridfile_,
+                                                            dir.substr(std::string("solution/").size())
+                                                            + "/Solution.h5")));
+
+    fout.open("solution/Solution.xmf");
+    fout << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"3.0\">\n"
+         << "  <Domain>\n"
+         << "  <Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+
+    for (const auto &entry: series_)
+        fout << entry.second;
+
+    fout << "  </Grid>\n"
+         << "  </Domain>\n"
+         << "</Xdmf>\n";
+}
+
+hid_t Hdf5Viewer::createFile(const std::string &filename) const
+{
+    hid_t plist = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_mpio(plist, comm_->communicator(), MPI_INFO_NULL);
+
+    hid_t fid = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, plist);
+    H5Pclose(plist);
+
+    if (fid < 0)
+        throw Exception("Hdf5Viewer", "createFile", "could not create file \"" + filename + "\".");
+
+    return fid;
+}
+
+hid_t Hdf5Viewer::datasetProperties(Size nRows, Size nComponents, bool lossy) const
+{
+    lossy = lossy && zfpAccuracy_ > 0.;
+
+    if (nRows == 0 || (deflateLevel_ == 0 && !shuffle_ && !lossy))
+        return H5P_DEFAULT;
+
+    //- Filters require chunked storage
+    const hsize_t chunkRows = 65536;
+    hsize_t chunkDims[2] = {std::min((hsize_t) nRows, chunkRows), nComponents};
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, nComponents == 1 ? 1 : 2, chunkDims);
+
+    if (lossy)
+    {
+        //- ZFP fixed accuracy mode, the tolerance is packed into the last two values
+        unsigned int cdValues[4] = {3, 0, 0, 0};
+        std::memcpy(&cdValues[2], &zfpAccuracy_, sizeof(double));
+        H5Pset_filter(dcpl, zfpFilter_, H5Z_FLAG_MANDATORY, 4, cdValues);
+    }
+    else
+    {
+        if (shuffle_)
+            H5Pset_shuffle(dcpl);
+
+        if (deflateLevel_ > 0)
+            H5Pset_deflate(dcpl, deflateLevel_);
+    }
+
+    return dcpl;
+}
+
+template<class T>
+void Hdf5Viewer::writeDataset(hid_t fid, const std::string &name, const std::vector<T> &vals,
+                              const std::vector<hsize_t> &rows, Size nRows, Size nComponents, hid_t memType,
+                              hid_t fileType, bool lossy) const
+{
+    hsize_t dims[2] = {nRows, nComponents};
+    hid_t fileSpace = H5Screate_simple(nComponents == 1 ? 1 : 2, dims, NULL);
+    hid_t dcpl = datasetProperties(nRows, nComponents, lossy);
+    hid_t dset = H5Dcreate2(fid, name.c_str(), fileType, fileSpace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+    if (dcpl != H5P_DEFAULT)
+        H5Pclose(dcpl);
+
+    //- Owned rows are scattered by the decomposition, consecutive rows are merged into blocks
+    hsize_t nVals = vals.size();
+    hid_t memSpace = H5Screate_simple(1, &nVals, NULL);
+    H5Sselect_none(fileSpace);
+
+    if (vals.empty())
+        H5Sselect_none(memSpace);
+
+    for (Label i = 0; i < rows.size();)
+    {
+        Label j = i + 1;
+        while (j < rows.size() && rows[j] == rows[j - 1] + 1)
+            ++j;
+
+        hsize_t start[2] = {rows[i], 0}, count[2] = {j - i, nComponents};
+        H5Sselect_hyperslab(fileSpace, H5S_SELECT_OR, start, NULL, count, NULL);
+        i = j;
+    }
+
+    hid_t xfer = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+
+    H5Dwrite(dset, memType, memSpace, fileSpace, xfer, vals.data());
+
+    H5Pclose(xfer);
+    H5Sclose(memSpace);
+    H5Dclose(dset);
+    H5Sclose(fileSpace);
+}
@@ -0,0 +1,79 @@
+#ifndef HDF5_VIEWER_H
+#define HDF5_VIEWER_H
+
+#include <hdf5.h>
+
+#include "Viewer.h"
+
+//- Writes one file per output time with collective parallel HDF5 I/O, with an XDMF sidecar for visualisation.
+//- Dataset rows follow the serial cell and node ids, so they do not depend on the decomposition and the grid is
+//- written once per run.
+//- Datasets can be compressed with the deflate/shuffle filters, and real valued fields with the lossy ZFP filter
+//- if its plugin is available
+class Hdf5Viewer : public Viewer
+{
+public:
+
+    Hdf5Viewer(const Input &input, const Solver &solver);
+
+    using Viewer::write;
+
+    void write(const Snapshot &snapshot);
+
+    bool asyncSafe() const;
+
+    void updateGrid();
+
+protected:
+
+    //- Owned cells and nodes of the current decomposition and their rows in the global datasets
+    void initGrid();
+
+    void writeGrid(const std::string &dir);
+
+    std::string xdmfGrid(Scalar solutionTime, const std::string &gridfile, const std::string &solutionfile) const;
+
+    //- Time steps of the existing time series, written by a previous run
+    void readXdmf();
+
+    void writeXdmf(Scalar solutionTime, const std::string &dir);
+
+    hid_t createFile(const std::string &filename) const;
+
+    //- Dataset creation properties for the selected compression filters
+    hid_t datasetProperties(Size nRows, Size nComponents, bool lossy) const;
+
+    //- Collectively write the rows owned by this proc of a global dataset, converting from the memory to file type.
+    //- Rows must be in increasing order
+    template<class T>
+    void writeDataset(hid_t fid, const std::string &name, const std::vector<T> &vals,
+                      const std::vector<hsize_t> &rows, Size nRows, Size nComponents, hid_t memType, hid_t fileType,
+                      bool lossy = false) const;
+
+    //- Private communicator, so that writes do not interfere with solver communication
+    std::shared_ptr<Communicator> comm_;
+
+    //- Owned cells sorted by serial id, and the rows owned by this proc
+    std::vector<Label> ownedCells_;
+    std::vector<hsize_t> cellRows_, nodeRows_;
+    Size nCellsGlobal_, nNodesGlobal_;
+    int nodesPerCell_;
+
+    //- Grid data owned by this proc. Each node is owned by a single proc, cells refer to serial node ids
+    std::vector<Scalar> gridNodes_;
+    std::vector<unsigned long> gridCells_;
+
+    //- Grid file relative to the solution directory, empty until written
+    std::string gridfile_;
+
+    //- Time series entries
+    std::vector<std::pair<Scalar, std::string>> series_;
+
+    //- Compression, lossy compression is disabled for a zero accuracy
+    static const H5Z_filter_t zfpFilter_ = 32013;
+    int deflateLevel_;
+    bool shuffle_;
+    Scalar zfpAccuracy_;
+};
+
+#endif
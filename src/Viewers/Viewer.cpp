@@ -1,6 +1,7 @@
 #include <boost/filesystem.hpp>
 
 #include "Viewer.h"
+#include "Exception.h"
 
 Viewer::Viewer(const Input &input, const Solver &solver)
     :
@@ -37,4 +38,74 @@ Viewer::Viewer(const Input &input, const Solver &solver)
         if(std::find(vectorFieldNames.begin(), vectorFieldNames.end(), field.first) != vectorFieldNames.end())
             vectorFields_.push_back(Ref<const VectorFiniteVolumeField>(*field.second));
     }
+
+    string precision = input.caseInput().get<string>("Viewer.precision", "double");
+
+    if(precision == "double")
+        singlePrecision_ = false;
+    else if(precision == "float")
+        singlePrecision_ = true;
+    else
+        throw Exception("Viewer", "Viewer", "invalid precision \"" + precision + "\".");
+
+    string floatFields = input.caseInput().get<string>("Viewer.floatFields", "");
+    string doubleFields = input.caseInput().get<string>("Viewer.doubleFields", "");
+
+    split(floatFieldNames_, floatFields, is_any_of(", "), token_compress_on);
+    split(doubleFieldNames_, doubleFields, is_any_of(", "), token_compress_on);
+}
+
+bool Viewer::singlePrecision(const std::string &fieldName) const
+{
+    if(std::find(floatFieldNames_.begin(), floatFieldNames_.end(), fieldName) != floatFieldNames_.end())
+        return true;
+    else if(std::find(doubleFieldNames_.begin(), doubleFieldNames_.end(), fieldName) != doubleFieldNames_.end())
+        return false;
+
+    return singlePrecision_;
+}
+
+void Viewer::write(Scalar solutionTime)
+{
+    Snapshot snap;
+    snapshot(solutionTime, snap);
+    write(snap);
+}
+
+void Viewer::addField(const ScalarFiniteVolumeField &field)
+{
+    scalarFields_.push_back(Ref<const ScalarFiniteVolumeField>(field));
+}
+
+void Viewer::addField(const VectorFiniteVolumeField &field)
+{
+    vectorFields_.push_back(Ref<const VectorFiniteVolumeField>(field));
+}
+
+void Viewer::snapshot(Scalar solutionTime, Snapshot &snapshot) const
+{
+    snapshot.time = solutionTime;
+    snapshot.rank = solver_.grid().comm().rank();
+
+    snapshot.integerFields.resize(integerFields_.size());
+    snapshot.scalarFields.resize(scalarFields_.size());
+    snapshot.vectorFields.resize(vectorFields_.size());
+
+    for(int i = 0; i < integerFields_.size(); ++i)
+    {
+        snapshot.integerFields[i].first = integerFields_[i].get().name();
+        snapshot.integerFields[i].second.assign(integerFields_[i].get().begin(), integerFields_[i].get().end());
+    }
+
+    for(int i = 0; i < scalarFields_.size(); ++i)
+    {
+        snapshot.scalarFields[i].first = scalarFields_[i].get().name();
+        snapshot.scalarFields[i].second.assign(scalarFields_[i].get().begin(), scalarFields_[i].get().end());
+    }
+
+    for(int i = 0; i < vectorFields_.size(); ++i)
+    {
+        snapshot.vectorFields[i].first = vectorFields_[i].get().name();
+        snapshot.vectorFields[i].second.assign(vectorFields_[i].get().begin(), vectorFields_[i].get().end());
+    }
 }
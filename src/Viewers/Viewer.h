@@ -9,9 +9,47 @@ class Viewer
 {
 public:
 
+    //- Copy of the output field data at a solution time, so that files can be written while the solver advances
+    struct Snapshot
+    {
+        Scalar time;
+        int rank;
+        std::vector<std::pair<std::string, std::vector<int>>> integerFields;
+        std::vector<std::pair<std::string, std::vector<Scalar>>> scalarFields;
+        std::vector<std::pair<std::string, std::vector<Vector2D>>> vectorFields;
+    };
+
     Viewer(const Input& input, const Solver& solver);
 
-    virtual void write(Scalar solutionTime) = 0;
+    virtual ~Viewer() {}
+
+    virtual void write(Scalar solutionTime);
+
+    //- Copy the output fields into a snapshot, reusing its storage
+    virtual void snapshot(Scalar solutionTime, Snapshot &snapshot) const;
+
+    //- Write a snapshot. Must not use the solver fields, it may be called from a background thread
+    virtual void write(const Snapshot &snapshot) = 0;
+
+    //- Whether write(const Snapshot&) can be called off the main thread
+    virtual bool asyncSafe() const
+    { return true; }
+
+    //- Block until all pending output has been written
+    virtual void flush() {}
+
+    //- Called after the grid has been repartitioned
+    virtual void updateGrid() {}
+
+    //- Add output fields that were not selected by the input, e.g. those created by post-processing. Must be
+    //- called before the first write
+    virtual void addField(const ScalarFiniteVolumeField &field);
+
+    virtual void addField(const VectorFiniteVolumeField &field);
+
+    //- Output precision, selected by Viewer.precision = double (default) or float, and overridden for the
+    //- fields listed in Viewer.floatFields/Viewer.doubleFields
+    bool singlePrecision(const std::string &fieldName) const;
 
 protected:
 
@@ -23,6 +61,9 @@ protected:
     std::vector< Ref<const ScalarFiniteVolumeField> > scalarFields_;
     std::vector< Ref<const VectorFiniteVolumeField> > vectorFields_;
 
+    bool singlePrecision_;
+    std::vector<std::string> floatFieldNames_, doubleFieldNames_;
+
 };
 
 #include "CgnsViewer.h"
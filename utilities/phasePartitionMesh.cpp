@@ -1,11 +1,158 @@
 #include <iostream>
+#include <set>
 
 #include <boost/filesystem.hpp>
 #include <cgnslib.h>
 
 #include "Input.h"
+#include "CommandLine.h"
 #include "ConstructGrid.h"
-#include "CgnsViewer.h"
+#include "Exception.h"
+
+//- Write a local domain in the layout read by CgnsUnstructuredGrid::loadPartitionedGrid
+void writeLocalDomain(const std::string &filename,
+                      const std::string &caseName,
+                      const FiniteVolumeGrid2D &grid,
+                      const FiniteVolumeGrid2D::LocalDomain &domain)
+{
+    int fid, bid, zid, xid, sid;
+
+    if (cg_open(filename.c_str(), CG_MODE_WRITE, &fid) != CG_OK)
+        throw Exception("", "writeLocalDomain", "could not open file \"" + filename + "\".");
+
+    cg_base_write(fid, caseName.c_str(), 2, 2, &bid);
+
+    cgsize_t nCells = domain.cellInds.size() - 1;
+    cgsize_t sizes[3] = {(cgsize_t) domain.nodes.size(), nCells, 0};
+    cg_zone_write(fid, bid, "Cells", sizes, CGNS_ENUMV(Unstructured), &zid);
+
+    //- Nodes
+    std::vector<double> coords(domain.nodes.size());
+
+    std::transform(domain.nodes.begin(), domain.nodes.end(), coords.begin(), [](const Point2D &pt) { return pt.x; });
+    cg_coord_write(fid, bid, zid, CGNS_ENUMV(RealDouble), "CoordinateX", coords.data(), &xid);
+
+    std::transform(domain.nodes.begin(), domain.nodes.end(), coords.begin(), [](const Point2D &pt) { return pt.y; });
+    cg_coord_write(fid, bid, zid, CGNS_ENUMV(RealDouble), "CoordinateY", coords.data(), &xid);
+
+    //- Cells
+    std::vector<cgsize_t> connectivity;
+    connectivity.reserve(5 * nCells);
+
+    for (cgsize_t i = 0; i < nCells; ++i)
+    {
+        connectivity.push_back(domain.cellInds[i + 1] - domain.cellInds[i] == 3 ? CGNS_ENUMV(TRI_3)
+                                                                                : CGNS_ENUMV(QUAD_4));
+
+        for (Label j = domain.cellInds[i]; j < domain.cellInds[i + 1]; ++j)
+            connectivity.push_back(domain.cellNodeIds[j] + 1);
+    }
+
+    int secId;
+    cg_section_write(fid, bid, zid, "GridElements", CGNS_ENUMV(MIXED), 1, nCells, 0, connectivity.data(), &secId);
+
+    //- Boundary patches
+    cgsize_t start = nCells + 1;
+
+    for (const auto &patch: domain.patches)
+    {
+        if (patch.second.empty()) //- Patches may be empty on some procs
+            continue;
+
+        cgsize_t end = start + patch.second.size() / 2 - 1;
+        std::vector<cgsize_t> elemIds;
+        connectivity.clear();
+
+        for (Label i = 0; i < patch.second.size(); i += 2)
+        {
+            connectivity.push_back(patch.second[i] + 1);
+            connectivity.push_back(patch.second[i + 1] + 1);
+            elemIds.push_back(start + i / 2);
+        }
+
+        cg_section_write(fid, bid, zid, (patch.first + "Elements").c_str(), CGNS_ENUMV(BAR_2), start, end, 0,
+                         connectivity.data(), &secId);
+
+        int bcId;
+        cg_boco_write(fid, bid, zid, patch.first.c_str(), CGNS_ENUMV(BCGeneral), CGNS_ENUMV(PointList),
+                      elemIds.size(), elemIds.data(), &bcId);
+        cg_boco_gridlocation_write(fid, bid, zid, bcId, CGNS_ENUMV(EdgeCenter));
+
+        start = end + 1;
+    }
+
+    //- Ownership and serial ids
+    cg_sol_write(fid, bid, zid, "Info", CGNS_ENUMV(CellCenter), &sid);
+
+    std::vector<int> procNo(domain.cellProc.begin(), domain.cellProc.end());
+    std::vector<int> globalIds(domain.globalCellIds.begin(), domain.globalCellIds.end());
+
+    int fieldId;
+    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "ProcNo", procNo.data(), &fieldId);
+    cg_field_write(fid, bid, zid, sid, CGNS_ENUMV(Integer), "GlobalID", globalIds.data(), &fieldId);
+
+    //- Serial node and face ids, the faces are given by their local node pairs and found in the serial grid
+    std::vector<int> nodeIds(domain.globalNodeIds.begin(), domain.globalNodeIds.end());
+    std::vector<int> faceNodeIds, faceIds;
+    std::set<std::pair<Label, Label>> faces;
+
+    for (cgsize_t i = 0; i < nCells; ++i)
+        for (Label j = domain.cellInds[i]; j < domain.cellInds[i + 1]; ++j)
+        {
+            Label n1 = domain.cellNodeIds[j];
+            Label n2 = domain.cellNodeIds[j + 1 < domain.cellInds[i + 1] ? j + 1 : domain.cellInds[i]];
+
+            if (!faces.insert(n1 < n2 ? std::make_pair(n1, n2) : std::make_pair(n2, n1)).second)
+                continue;
+
+            faceNodeIds.push_back(n1);
+            faceNodeIds.push_back(n2);
+            faceIds.push_back(grid.findFace(domain.globalNodeIds[n1], domain.globalNodeIds[n2]));
+        }
+
+    int nSerialFaces = grid.nFaces();
+
+    cg_goto(fid, bid, "Zone_t", zid, "end");
+    cg_user_data_write("SerialIds");
+    cg_goto(fid, bid, "Zone_t", zid, "SerialIds", 0, "end");
+
+    cgsize_t size = nodeIds.size();
+    cg_array_write("Nodes", CGNS_ENUMV(Integer), 1, &size, nodeIds.data());
+
+    size = faceNodeIds.size();
+    cg_array_write("FaceNodes", CGNS_ENUMV(Integer), 1, &size, faceNodeIds.data());
+
+    size = faceIds.size();
+    cg_array_write("Faces", CGNS_ENUMV(Integer), 1, &size, faceIds.data());
+
+    size = 1;
+    cg_array_write("NSerialFaces", CGNS_ENUMV(Integer), 1, &size, &nSerialFaces);
+
+    cg_close(fid);
+}
+
+//- Send orders are the serial ids of the cells in the buffer of each neighbouring proc, in its local order
+void writeSendOrders(const std::string &filename, const std::vector<std::vector<int>> &sendOrders)
+{
+    int fid;
+    cg_open(filename.c_str(), CG_MODE_MODIFY, &fid);
+
+    cg_goto(fid, 1, "Zone_t", 1, "end");
+    cg_user_data_write("SendOrders");
+    cg_goto(fid, 1, "Zone_t", 1, "SendOrders", 0, "end");
+
+    for (int proc = 0; proc < sendOrders.size(); ++proc)
+    {
+        if (sendOrders[proc].empty())
+            continue;
+
+        cgsize_t size = sendOrders[proc].size();
+        cg_array_write(("Proc" + std::to_string(proc)).c_str(), CGNS_ENUMV(Integer), 1, &size,
+                       sendOrders[proc].data());
+    }
+
+    cg_close(fid);
+}
 
 int main(int argc, char *argv[])
 {
@@ -13,33 +160,60 @@ int main(int argc, char *argv[])
 
     Communicator::init(argc, argv);
 
-    auto comm = std::make_shared<Communicator>();
+    Communicator comm;
+
+    CommandLine cl;
+    cl.setOptions({
+                          {"--help",    "Displays this help message"},
+                          {"--version", "Displays version information"},
+                          {"--nProcs",  "Number of partitions to create"}
+                  });
+    cl.parseArguments(argc, argv);
+
+    int nProcs = std::stoi(cl.getOption("--nProcs"));
 
-    if(comm->isMainProc())
+    if (nProcs < 1)
+        throw Exception("", "main", "number of partitions must be greater than zero.");
+
+    if (comm.isMainProc())
     {
-        int fn;
-        cg_open(argv[1], CG_MODE_READ, &fn);
+        Input input;
+        input.parseInputFile();
+
+        //- The serial grid is only read and partitioned once, here
+        auto grid = constructSerialGrid(input);
+        Scalar minBufferWidth = input.caseInput().get<Scalar>("Grid.minBufferWidth", 0.);
+        string caseName = input.caseInput().get<string>("CaseName");
 
-        char name[256];
-        int cell_dim, phys_dim;
-        cg_base_read(fn, 1, name, &cell_dim, &phys_dim);
-        int nzones;
-        cg_nzones(fn, 1, &nzones);
+        cout << "Partitioning grid into " << nProcs << " partitions..." << endl;
+        vector<int> cellPartition = nProcs == 1 ? vector<int>(grid->nCells(), 0) : grid->computePartition(nProcs);
 
-        for(int zone = 1; zone <= nzones; ++zone)
+        //- sendOrders[p][q] are the cells owned by p that are buffered on q
+        vector<vector<vector<int>>> sendOrders(nProcs, vector<vector<int>>(nProcs));
+
+        for (int proc = 0; proc < nProcs; ++proc)
         {
-            cgsize_t size[2];
-            cg_zone_read(fn, 1, zone, name, size);
-            cgsize_t rmin = 1, rmax = size[0];
-            std::vector<double> coordsX(size[0]), coordsY(size[0]);
-            cg_coord_read(fn, 1, zone, "CoordinateX", CGNS_ENUMV(RealDouble), &rmin, &rmax, coordsX.data());
-            cg_coord_read(fn, 1, zone, "CoordinateY", CGNS_ENUMV(RealDouble), &rmin, &rmax, coordsY.data());
+            FiniteVolumeGrid2D::LocalDomain domain = grid->localDomain(cellPartition, proc, minBufferWidth);
+
+            for (Label id = 0; id < domain.cellProc.size(); ++id)
+                if (domain.cellProc[id] != proc)
+                    sendOrders[domain.cellProc[id]][proc].push_back(domain.globalCellIds[id]);
+
+            string dir = "solution/Proc" + std::to_string(proc);
+            boost::filesystem::create_directories(dir);
+            writeLocalDomain(dir + "/Grid.cgns", caseName, *grid, domain);
+
+            cout << "Wrote partition " << proc << " with " << domain.cellInds.size() - 1 << " cells and "
+                 << domain.nodes.size() << " nodes." << endl;
         }
 
-        cg_close(fn);
+        for (int proc = 0; proc < nProcs; ++proc)
+            writeSendOrders("solution/Proc" + std::to_string(proc) + "/Grid.cgns", sendOrders[proc]);
+
+        cout << "Finished partitioning. Set \"Grid.partitioned = true\" to run on the partitioned grid." << endl;
     }
 
     Communicator::finalize();
 
     return 0;
-}
\ No newline at end of file
+}
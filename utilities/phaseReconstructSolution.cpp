@@ -1,36 +1,216 @@
 #include <vector>
-#include <unordered_map>
+#include <array>
+#include <map>
 #include <set>
 
 #include <regex>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <limits>
+#include <algorithm>
 
 #include <cgnslib.h>
-#include <boost/geometry.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
 
-typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> Node;
+#include "Communicator.h"
+#include "CommandLine.h"
+#include "Exception.h"
+
+//- Ownership and serial ids of the cells of a partitioned grid, read from its "Info" solution
+struct Partition
+{
+    std::vector<int> procNo, globalIds;
+};
+
+Partition readPartition(const boost::filesystem::path &gridfile)
+{
+    int fn;
+    if (cg_open(gridfile.c_str(), CG_MODE_READ, &fn) != CG_OK)
+        throw Exception("", "readPartition", "could not open grid file \"" + gridfile.string() + "\".");
+
+    char name[256];
+    cgsize_t sizes[3];
+    cg_zone_read(fn, 1, 1, name, sizes);
+
+    Partition partition;
+    partition.procNo.resize(sizes[1]);
+    partition.globalIds.resize(sizes[1]);
+
+    cgsize_t rmin = 1, rmax = sizes[1];
+    cg_field_read(fn, 1, 1, 1, "ProcNo", CGNS_ENUMV(Integer), &rmin, &rmax, partition.procNo.data());
+    cg_field_read(fn, 1, 1, 1, "GlobalID", CGNS_ENUMV(Integer), &rmin, &rmax, partition.globalIds.data());
+
+    cg_close(fn);
+
+    return partition;
+}
+
+//- Serial ids of the nodes of a partitioned grid, which replace a geometric merge of the proc grids
+std::vector<int> readSerialNodeIds(int fn, const boost::filesystem::path &gridfile)
+{
+    if (cg_goto(fn, 1, "Zone_t", 1, "SerialIds", 0, "end") == CG_OK)
+    {
+        int nArrays;
+        cg_narrays(&nArrays);
+
+        for (int arrayId = 1; arrayId <= nArrays; ++arrayId)
+        {
+            char name[33];
+            CGNS_ENUMT(DataType_t) type;
+            int nDims;
+            cgsize_t dims[12];
+
+            cg_array_info(arrayId, name, &type, &nDims, dims);
+
+            if (std::string(name) == "Nodes")
+            {
+                std::vector<int> ids(dims[0]);
+                cg_array_read_as(arrayId, CGNS_ENUMV(Integer), ids.data());
+                return ids;
+            }
+        }
+    }
+
+    throw Exception("", "readSerialNodeIds", "grid file \"" + gridfile.string() + "\" has no serial node ids.");
+}
+
+//- The grid a solution file was written on. Grids are replaced when the domain is repartitioned, so this is
+//- found from the link of its coordinates
+boost::filesystem::path linkedGrid(int fn, const boost::filesystem::path &solutionFile)
+{
+    int length;
+    cg_goto(fn, 1, "Zone_t", 1, "GridCoordinates_t", 1, "end");
+    cg_is_link(&length);
+
+    if (length == 0)
+        return solutionFile;
+
+    char *filename, *path;
+    cg_link_read(&filename, &path);
+    boost::filesystem::path gridfile = solutionFile.parent_path() / filename;
+    cg_free(filename);
+    cg_free(path);
+
+    return gridfile;
+}
+
+//- Contiguous slices of the serial ids, each assembled and written by one proc
+class Slices
+{
+public:
+
+    Slices(unsigned long n, int nProcs) : begins_(nProcs + 1)
+    {
+        for (int proc = 0; proc <= nProcs; ++proc)
+            begins_[proc] = n * proc / nProcs;
+    }
+
+    int owner(unsigned long id) const
+    { return std::upper_bound(begins_.begin(), begins_.end(), id) - begins_.begin() - 1; }
+
+    unsigned long begin(int proc) const
+    { return begins_[proc]; }
+
+    unsigned long size(int proc) const
+    { return begins_[proc + 1] - begins_[proc]; }
+
+private:
+
+    std::vector<unsigned long> begins_;
+};
+
+//- Route values keyed by serial id to the procs assembling their slices, and place them in the local slice
+template<class T>
+std::vector<T> assembleSlice(const Communicator &comm,
+                             const Slices &slices,
+                             const std::vector<unsigned long> &ids,
+                             const std::vector<T> &vals,
+                             int nComponents = 1)
+{
+    std::vector<std::vector<unsigned long>> sendIds(comm.nProcs());
+    std::vector<std::vector<T>> sendVals(comm.nProcs());
+
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+        int proc = slices.owner(ids[i]);
+        sendIds[proc].push_back(ids[i]);
+        sendVals[proc].insert(sendVals[proc].end(), vals.begin() + i * nComponents,
+                              vals.begin() + (i + 1) * nComponents);
+    }
+
+    auto recvIds = comm.allToAllv(sendIds);
+    auto recvVals = comm.allToAllv(sendVals);
+
+    std::vector<T> slice(slices.size(comm.rank()) * nComponents);
+
+    for (int proc = 0; proc < comm.nProcs(); ++proc)
+        for (std::size_t i = 0; i < recvIds[proc].size(); ++i)
+            std::copy(recvVals[proc].begin() + i * nComponents, recvVals[proc].begin() + (i + 1) * nComponents,
+                      slice.begin() + (recvIds[proc][i] - slices.begin(comm.rank())) * nComponents);
+
+    return slice;
+}
+
+//- Execute write(fn) on each proc in turn, so that a file is written in slices with the serial CGNS library
+template<class Write>
+void writeInTurn(const Communicator &comm, const std::string &filename, const Write &write)
+{
+    for (int proc = 0; proc < comm.nProcs(); ++proc)
+    {
+        if (proc == comm.rank())
+        {
+            int fn;
+            cg_open(filename.c_str(), CG_MODE_MODIFY, &fn);
+            write(fn);
+            cg_close(fn);
+        }
+
+        comm.barrier();
+    }
+}
 
 int main(int argc, char *argv[])
 {
     using namespace std;
     using namespace boost::filesystem;
 
-    //- Build directory lists
+    Communicator::init(argc, argv);
+    Communicator comm;
+
+    CommandLine cl;
+    cl.setOptions({
+                          {"--help",      "Displays this help message"},
+                          {"--version",   "Displays version information"},
+                          {"--startTime", "Reconstruct solutions from this time (default all)"},
+                          {"--endTime",   "Reconstruct solutions up to this time (default all)"},
+                          {"--fields",    "Comma separated list of fields to reconstruct (default all)"}
+                  });
+    cl.parseArguments(argc, argv);
+
+    double startTime = std::stod(cl.getOption("--startTime", "0"));
+    double endTime = std::stod(cl.getOption("--endTime", std::to_string(std::numeric_limits<double>::max())));
+
+    std::set<std::string> selectedFields;
+    std::string fieldList = cl.getOption("--fields", "");
+    boost::split(selectedFields, fieldList, boost::is_any_of(", "), boost::token_compress_on);
+    selectedFields.erase("");
+
+    //- Build directory lists, with the proc number of each processor directory
     regex re("Proc([0-9]+)"); // Check a processor directory
-    set<path, std::function<bool(const path &, const path &)>> gridDirs([re](const path &p1, const path &p2) {
-        smatch matches[2];
-        std::regex_search(p1.string(), matches[0], re);
-        std::regex_search(p2.string(), matches[1], re);
-        return stoi(matches[0][1].str()) < stoi(matches[1][1].str());
-    });
+    std::map<int, path> gridDirs;
 
-    //- Load the global grids first
     for (directory_iterator end, dir("./solution"); dir != end; ++dir)
-        if (regex_match(dir->path().filename().string(), re))
-            gridDirs.insert(dir->path());
+    {
+        smatch match;
+        std::string filename = dir->path().filename().string();
+
+        if (regex_match(filename, match, re))
+            gridDirs[stoi(match[1].str())] = dir->path();
+    }
 
-    //- Load transient solution data
+    //- Transient solution data within the time range
     re = regex("[0-9]+\\.[0-9]+");
     set<path, std::function<bool(const path &, const path &)>> solutionDirs([re](const path &p1, const path &p2) {
         smatch matches[2];
@@ -41,17 +221,36 @@ int main(int argc, char *argv[])
 
     for (directory_iterator end, dir("./solution"); dir != end; ++dir)
         if (regex_match(dir->path().filename().string(), re))
-            solutionDirs.insert(dir->path());
+        {
+            double time = std::stod(dir->path().filename().string());
 
-    //- Read in global node/elements
-    std::vector<Node> nodes;
-    std::vector<cgsize_t> elements;
-    cgsize_t nElements = 0;
+            if (time >= startTime && time <= endTime)
+                solutionDirs.insert(dir->path());
+        }
+
+    //- Processor directories are distributed over the procs. No proc holds more than its directories and its slice
+    //- of the serial grid and fields
+    std::vector<std::pair<int, path>> localDirs;
+    int i = 0;
+
+    for (const auto &gridDir: gridDirs)
+        if (i++ % comm.nProcs() == comm.rank())
+            localDirs.push_back(gridDir);
 
-    for (const auto &path: gridDirs)
+    //- The serial grid is assembled from the cells owned by each proc, the nodes are given by their serial ids.
+    //- Directories left by runs on more procs hold grids of an older decomposition, but the same serial ids
+    std::vector<unsigned long> nodeIds, cellIds;
+    std::vector<double> coords;
+    std::vector<cgsize_t> elementIds;
+    int maxNodeId = -1, maxCellId = -1;
+
+    for (const auto &gridDir: localDirs)
     {
+        path gridfile = gridDir.second / "Grid.cgns";
         int fn;
-        cg_open((path / "Grid.cgns").c_str(), CG_MODE_READ, &fn);
+
+        if (cg_open(gridfile.c_str(), CG_MODE_READ, &fn) != CG_OK)
+            throw Exception("", "main", "could not open grid file \"" + gridfile.string() + "\".");
 
         char name[256];
         cgsize_t sizes[3];
@@ -63,12 +262,15 @@ int main(int argc, char *argv[])
         cg_coord_read(fn, 1, 1, "CoordinateX", CGNS_ENUMV(RealDouble), &rmin, &rmax, buffer[0].data());
         cg_coord_read(fn, 1, 1, "CoordinateY", CGNS_ENUMV(RealDouble), &rmin, &rmax, buffer[1].data());
 
-        cgsize_t offset = nodes.size();
+        std::vector<int> serialNodeIds = readSerialNodeIds(fn, gridfile);
 
-        std::transform(buffer[0].begin(), buffer[0].end(),
-                       buffer[1].begin(), std::back_inserter(nodes), [](double x, double y) -> Node {
-                    return Node(x, y);
-                });
+        for (int j = 0; j < sizes[0]; ++j)
+        {
+            nodeIds.push_back(serialNodeIds[j]);
+            coords.push_back(buffer[0][j]);
+            coords.push_back(buffer[1][j]);
+            maxNodeId = std::max(maxNodeId, serialNodeIds[j]);
+        }
 
         cgsize_t elementDataSize, parentData;
         cg_ElementDataSize(fn, 1, 1, 1, &elementDataSize);
@@ -76,233 +278,305 @@ int main(int argc, char *argv[])
         std::vector<cgsize_t> elementBuffer(elementDataSize);
         cg_elements_read(fn, 1, 1, 1, elementBuffer.data(), &parentData);
 
-        for (int i = 0; i < elementBuffer.size();)
+        cg_close(fn);
+
+        Partition partition = readPartition(gridfile);
+
+        //- Elements are routed as fixed size records of the element type and up to four 1-based serial node ids
+        for (int j = 0, cellNo = 0; j < elementBuffer.size(); ++cellNo)
         {
-            elements.push_back(elementBuffer[i]);
-            switch (elementBuffer[i++])
-            {
-                case CGNS_ENUMV(TRI_3):
-                    for (int j = 0; j < 3; ++j)
-                        elements.push_back(elementBuffer[i++] + offset);
-                    break;
-                case CGNS_ENUMV(QUAD_4):
-                    for (int j = 0; j < 4; ++j)
-                        elements.push_back(elementBuffer[i++] + offset);
-                    break;
-            }
+            std::array<cgsize_t, 5> cell = {elementBuffer[j], 0, 0, 0, 0};
+            int nCellNodes = elementBuffer[j++] == CGNS_ENUMV(TRI_3) ? 3 : 4;
+
+            for (int k = 0; k < nCellNodes; ++k)
+                cell[k + 1] = serialNodeIds[elementBuffer[j++] - 1] + 1;
 
-            ++nElements;
+            if (partition.procNo[cellNo] != gridDir.first)
+                continue;
+
+            cellIds.push_back(partition.globalIds[cellNo]);
+            elementIds.insert(elementIds.end(), cell.begin(), cell.end());
+            maxCellId = std::max(maxCellId, partition.globalIds[cellNo]);
         }
-        cg_close(fn);
     }
 
-    //- Compute merges
-    std::vector<cgsize_t> nodeIds(nodes.size(), -1);
+    cgsize_t nNodes = comm.max(maxNodeId) + 1, nElements = comm.max(maxCellId) + 1;
+    Slices nodeSlices(nNodes, comm.nProcs()), cellSlices(nElements, comm.nProcs());
+
+    coords = assembleSlice(comm, nodeSlices, nodeIds, coords, 2);
+
+    std::vector<cgsize_t> elements;
 
     {
-        boost::geometry::index::rtree<pair<Node, cgsize_t>, boost::geometry::index::quadratic<32>> rtree;
+        std::vector<int> records(elementIds.begin(), elementIds.end());
+        records = assembleSlice(comm, cellSlices, cellIds, records, 5);
 
-        cgsize_t id = 1;
-        for (const Node &node: nodes)
-            rtree.insert(std::make_pair(node, id++));
+        for (std::size_t j = 0; j < records.size(); j += 5)
+            elements.insert(elements.end(), records.begin() + j,
+                            records.begin() + j + (records[j] == CGNS_ENUMV(TRI_3) ? 4 : 5));
+    }
 
-        double tolerance = 1e-15;
-        std::vector<Node> tmp;
+    nodeIds.clear();
+    cellIds.clear();
+    elementIds.clear();
 
-        id = 1;
-        for (const auto &node: rtree)
-        {
-            if (nodeIds[node.second - 1] != -1) // Node already has id
-                continue;
+    comm.printf("Number of nodes: %d\nNumber of elements: %d\n", (int) nNodes, (int) nElements);
+
+    //- Write the grid
+    if (comm.isMainProc())
+    {
+        int fn, bid, zid, sid;
+        cg_open("solution.cgns", CG_MODE_WRITE, &fn);
+        cg_base_write(fn, "Base", 2, 2, &bid);
+
+        cgsize_t sizes[] = {nNodes, nElements, 0};
+        cg_zone_write(fn, bid, "Cells", sizes, CGNS_ENUMT(Unstructured), &zid);
+        cg_section_partial_write(fn, bid, zid, "Cells", CGNS_ENUMV(MIXED), 1, nElements, 0, &sid);
+        cg_close(fn);
+    }
 
-            boost::geometry::model::box<Node> box(
-                    Node(node.first.get<0>() - tolerance, node.first.get<1>() - tolerance),
-                    Node(node.first.get<0>() + tolerance, node.first.get<1>() + tolerance)
-            );
+    comm.barrier();
 
-            std::vector<std::pair<Node, cgsize_t>> mergeToNode;
-            rtree.query(boost::geometry::index::covered_by(box), std::back_inserter(mergeToNode));
+    writeInTurn(comm, "solution.cgns", [&](int fn) {
+        if (nodeSlices.size(comm.rank()) > 0)
+        {
+            std::vector<double> buffer(nodeSlices.size(comm.rank()));
+            cgsize_t rmin = nodeSlices.begin(comm.rank()) + 1, rmax = rmin + buffer.size() - 1;
+            int xid;
 
-            for (const auto &mNode: mergeToNode)
-                nodeIds[mNode.second - 1] = id;
+            for (int component = 0; component < 2; ++component)
+            {
+                for (std::size_t j = 0; j < buffer.size(); ++j)
+                    buffer[j] = coords[2 * j + component];
 
-            tmp.push_back(node.first);
-            ++id;
+                cg_coord_partial_write(fn, 1, 1, CGNS_ENUMV(RealDouble),
+                                       component == 0 ? "CoordinateX" : "CoordinateY",
+                                       &rmin, &rmax, buffer.data(), &xid);
+            }
         }
 
-        std::cout << "Number of nodes: " << nodes.size() << std::endl
-                  << "Number of unique nodes: " << tmp.size()
-                  << std::endl;
+        if (cellSlices.size(comm.rank()) > 0)
+            cg_elements_partial_write(fn, 1, 1, 1, cellSlices.begin(comm.rank()) + 1,
+                                      cellSlices.begin(comm.rank()) + cellSlices.size(comm.rank()),
+                                      elements.data());
+    });
 
-        nodes = tmp;
-    }
+    coords.clear();
+    elements.clear();
 
-    std::vector<cgsize_t> elementIds(nElements, -1);
+    //- Each time step is streamed field by field. Every proc reads the solutions of its directories and writes its
+    //- slice of each field into a file that links to the serial grid
+    std::map<path, Partition> partitions;
+    std::vector<path> timeDirs(solutionDirs.begin(), solutionDirs.end());
 
+    for (const path &dir: timeDirs)
     {
-        std::map<std::set<cgsize_t>, cgsize_t> elementSet;
-        std::vector<cgsize_t> tmp;
-        cgsize_t id = 1;
-        cgsize_t nUniqueElements = 0;
-        for (int i = 0; i < elements.size();)
+        comm.printf("Reconstructing: %s...\n", dir.string().c_str());
+
+        //- Processor directories without a solution at this time were left by a run on more procs
+        std::vector<int> fns, procNos;
+        std::vector<const Partition *> procPartitions;
+
+        for (const auto &gridDir: localDirs)
         {
-            std::vector<cgsize_t> element(1, elements[i]);
+            path solutionFile = dir / gridDir.second.filename() / "Solution.cgns";
 
-            switch (elements[i++])
-            {
-                case CGNS_ENUMV(TRI_3):
-                    for (int j = 0; j < 3; ++j)
-                    {
-                        elements[i] = nodeIds[elements[i] - 1];
-                        element.push_back(elements[i++]);
-                    }
-                    break;
-                case CGNS_ENUMV(QUAD_4):
-                    for (int j = 0; j < 4; ++j)
-                    {
-                        elements[i] = nodeIds[elements[i] - 1];
-                        element.push_back(elements[i++]);
-                    }
-                    break;
-            }
+            if (!exists(solutionFile))
+                continue;
 
-            auto insert = elementSet.insert(std::make_pair(std::set<cgsize_t>(element.begin() + 1, element.end()), id));
+            int fn2;
+            if (cg_open(solutionFile.c_str(), CG_MODE_READ, &fn2) != CG_OK)
+                throw Exception("", "main", "could not open solution file \"" + solutionFile.string() + "\".");
 
-            if (insert.second)
-            {
-                elementIds[id++ - 1] = ++nUniqueElements;
-                tmp.insert(tmp.end(), element.begin(), element.end());
-            }
-            else
+            path gridfile = canonical(linkedGrid(fn2, solutionFile));
+
+            if (partitions.find(gridfile) == partitions.end())
+                partitions[gridfile] = readPartition(gridfile);
+
+            fns.push_back(fn2);
+            procNos.push_back(gridDir.first);
+            procPartitions.push_back(&partitions[gridfile]);
+        }
+
+        //- The field names are taken from the first proc, so that all procs reconstruct the same fields
+        std::vector<std::pair<std::string, CGNS_ENUMT(DataType_t)>> fields;
+
+        if (comm.isMainProc())
+        {
+            int fn2, nFields = 0;
+            cg_open((dir / gridDirs.begin()->second.filename() / "Solution.cgns").c_str(), CG_MODE_READ, &fn2);
+            cg_nfields(fn2, 1, 1, 1, &nFields);
+
+            for (int fieldNo = 1; fieldNo <= nFields; ++fieldNo)
             {
-                elementIds[id++ - 1] = elementIds[insert.first->second - 1];
+                char name[256];
+                CGNS_ENUMT(DataType_t) type;
+                cg_field_info(fn2, 1, 1, 1, fieldNo, &type, name);
+
+                //- Vector components are selected by the vector name
+                std::string fieldName = name;
+                std::string vectorName = fieldName.substr(0, fieldName.size() - 1);
+
+                if (!selectedFields.empty()
+                    && selectedFields.find(fieldName) == selectedFields.end()
+                    && selectedFields.find(vectorName) == selectedFields.end())
+                    continue;
+
+                if (type == CGNS_ENUMV(Integer) || type == CGNS_ENUMV(RealSingle) || type == CGNS_ENUMV(RealDouble))
+                    fields.push_back(std::make_pair(fieldName, type));
             }
+
+            cg_close(fn2);
         }
 
-        std::cout << "Number of elements: " << nElements << std::endl
-                  << "Number of unique elements: " << nUniqueElements << std::endl;
+        std::string fieldNames;
+        std::vector<int> fieldTypes;
 
-        nElements = nUniqueElements;
-        elements = tmp;
-    }
+        for (const auto &field: fields)
+        {
+            fieldNames += field.first + " ";
+            fieldTypes.push_back(field.second);
+        }
 
-    //- Write the grid
-    int fn, bid, zid, xid, sid;
-    cg_open("solution.cgns", CG_MODE_WRITE, &fn);
-    cg_base_write(fn, "Base", 2, 2, &bid);
+        comm.broadcast(comm.mainProcNo(), fieldNames);
+        comm.broadcast(comm.mainProcNo(), fieldTypes);
 
-    cgsize_t sizes[] = {(cgsize_t) nodes.size(), nElements, 0};
-    cg_zone_write(fn, bid, "Cells", sizes, CGNS_ENUMT(Unstructured), &zid);
+        std::istringstream is(fieldNames);
+        fields.clear();
 
-    std::vector<double> buffer(nodes.size());
+        for (int type: fieldTypes)
+        {
+            std::string name;
+            is >> name;
+            fields.push_back(std::make_pair(name, (CGNS_ENUMT(DataType_t)) type));
+        }
 
-    std::transform(nodes.begin(), nodes.end(), buffer.begin(), [](const Node &node) { return node.get<0>(); });
-    cg_coord_write(fn, bid, zid, CGNS_ENUMV(RealDouble), "CoordinateX", buffer.data(), &xid);
+        //- Assemble the slices of all fields, values are routed as doubles, which hold integers exactly
+        std::vector<std::vector<double>> slices;
 
-    std::transform(nodes.begin(), nodes.end(), buffer.begin(), [](const Node &node) { return node.get<1>(); });
-    cg_coord_write(fn, bid, zid, CGNS_ENUMV(RealDouble), "CoordinateY", buffer.data(), &xid);
+        for (const auto &field: fields)
+        {
+            std::vector<unsigned long> ids;
+            std::vector<double> vals, buffer;
 
-    cg_section_write(fn, bid, zid, "Cells", CGNS_ENUMV(MIXED), 1, sizes[1], sizes[2], elements.data(), &sid);
+            for (int j = 0; j < fns.size(); ++j)
+            {
+                const Partition &partition = *procPartitions[j];
+                cgsize_t rmin = 1, rmax = partition.procNo.size();
 
-    //- Write solutions
-    std::vector<double> timeValues;
-    std::ostringstream flowSolutionPtrs;
+                buffer.resize(partition.procNo.size());
+                cg_field_read(fns[j], 1, 1, 1, field.first.c_str(), CGNS_ENUMV(RealDouble), &rmin, &rmax,
+                              buffer.data());
 
-    int solutionNo = 1;
+                for (int k = 0; k < buffer.size(); ++k)
+                    if (partition.procNo[k] == procNos[j])
+                    {
+                        ids.push_back(partition.globalIds[k]);
+                        vals.push_back(buffer[k]);
+                    }
+            }
 
-    for (const auto &path: solutionDirs)
-    {
-        double time = std::stod(path.filename().string());
-        timeValues.push_back(time);
+            slices.push_back(assembleSlice(comm, cellSlices, ids, vals));
+        }
+
+        for (int fn2: fns)
+            cg_close(fn2);
 
-        std::unordered_map<std::string, std::vector<double>> doubleFields;
-        std::unordered_map<std::string, std::vector<int>> intFields;
+        std::string filename = (dir / "Reconstructed.cgns").string();
 
-        for (const auto &subpath: gridDirs)
+        if (comm.isMainProc())
         {
-            std::cout << "Loading: " << path / subpath.filename() / "Solution.cgns" << "..." << std::endl;
+            int fn, bid, zid, sid;
+            cg_open(filename.c_str(), CG_MODE_WRITE, &fn);
+            cg_base_write(fn, "Base", 2, 2, &bid);
 
-            int fn2;
-            cg_open((path / subpath.filename() / "Solution.cgns").c_str(), CG_MODE_READ, &fn2);
+            cgsize_t sizes[] = {nNodes, nElements, 0};
+            cg_zone_write(fn, bid, "Cells", sizes, CGNS_ENUMT(Unstructured), &zid);
+
+            cg_goto(fn, bid, "Zone_t", zid, "end");
+            cg_link_write("GridCoordinates", "../../solution.cgns", "/Base/Cells/GridCoordinates");
+            cg_link_write("Cells", "../../solution.cgns", "/Base/Cells/Cells");
+
+            cg_sol_write(fn, bid, zid, "FlowSolution", CGNS_ENUMV(CellCenter), &sid);
+            cg_close(fn);
+        }
 
-            char name[256];
-            cg_zone_read(fn2, 1, 1, name, sizes);
+        comm.barrier();
 
-            int nfields = 0;
-            cg_nfields(fn2, 1, 1, 1, &nfields);
+        writeInTurn(comm, filename, [&](int fn) {
+            if (cellSlices.size(comm.rank()) == 0)
+                return;
 
-            for (int field = 1; field <= nfields; ++field)
+            cgsize_t rmin = cellSlices.begin(comm.rank()) + 1, rmax = rmin + cellSlices.size(comm.rank()) - 1;
+            int fieldId;
+
+            for (int j = 0; j < fields.size(); ++j)
             {
-                CGNS_ENUMT(DataType_t) type;
-                cg_field_info(fn2, 1, 1, 1, field, &type, name);
-                cgsize_t rmin = 1, rmax = sizes[1];
+                const std::vector<double> &slice = slices[j];
 
-                switch (type)
+                switch (fields[j].second)
                 {
                     case CGNS_ENUMV(Integer):
                     {
-                        std::vector<int> buffer(sizes[1]);
-                        cg_field_read(fn2, 1, 1, 1, name, CGNS_ENUMV(Integer), &rmin, &rmax, buffer.data());
-                        intFields[name].insert(intFields[name].end(), buffer.begin(), buffer.end());
-                    }
+                        std::vector<int> vals(slice.begin(), slice.end());
+                        cg_field_partial_write(fn, 1, 1, 1, fields[j].second, fields[j].first.c_str(), &rmin, &rmax,
+                                               vals.data(), &fieldId);
                         break;
-                    case CGNS_ENUMV(RealDouble):
+                    }
+                    case CGNS_ENUMV(RealSingle):
                     {
-                        std::vector<double> buffer(sizes[1]);
-                        cg_field_read(fn2, 1, 1, 1, name, CGNS_ENUMV(RealDouble), &rmin, &rmax, buffer.data());
-                        doubleFields[name].insert(doubleFields[name].end(), buffer.begin(), buffer.end());
+                        std::vector<float> vals(slice.begin(), slice.end());
+                        cg_field_partial_write(fn, 1, 1, 1, fields[j].second, fields[j].first.c_str(), &rmin, &rmax,
+                                               vals.data(), &fieldId);
+                        break;
                     }
+                    default:
+                        cg_field_partial_write(fn, 1, 1, 1, fields[j].second, fields[j].first.c_str(), &rmin, &rmax,
+                                               slice.data(), &fieldId);
                         break;
                 }
             }
+        });
+    }
 
-            cg_close(fn2);
-        }
-
-        std::string flowSolutionPtr = "FlowSolution" + std::to_string(solutionNo);
-        flowSolutionPtrs << setw(32) << setfill(' ') << left << flowSolutionPtr;
+    //- Link the reconstructed solutions into the main file
+    if (comm.isMainProc())
+    {
+        int fn;
+        cg_open("solution.cgns", CG_MODE_MODIFY, &fn);
 
-        int sid;
-        cg_sol_write(fn, 1, 1, flowSolutionPtr.c_str(), CGNS_ENUMV(CellCenter), &sid);
+        std::vector<double> timeValues;
+        std::ostringstream flowSolutionPtrs;
+        int solutionNo = 1;
 
-        for (const auto &field: intFields)
+        for (const auto &dir: timeDirs)
         {
-            int fieldId;
-            std::vector<int> buffer(nElements);
-            for(int i = 0; i < field.second.size(); ++i)
-                buffer[elementIds[i] - 1] = field.second[i];
+            timeValues.push_back(std::stod(dir.filename().string()));
 
-            cg_field_write(fn, 1, 1, sid, CGNS_ENUMV(Integer), field.first.c_str(), buffer.data(), &fieldId);
-        }
-
-        for (const auto &field: doubleFields)
-        {
-            int fieldId;
-            std::vector<double> buffer(nElements);
-            for(int i = 0; i < field.second.size(); ++i)
-                buffer[elementIds[i] - 1] = field.second[i];
+            std::string flowSolutionPtr = "FlowSolution" + std::to_string(solutionNo++);
+            flowSolutionPtrs << setw(32) << setfill(' ') << left << flowSolutionPtr;
 
-            cg_field_write(fn, 1, 1, sid, CGNS_ENUMV(RealDouble), field.first.c_str(), buffer.data(), &fieldId);
+            cg_goto(fn, 1, "Zone_t", 1, "end");
+            cg_link_write(flowSolutionPtr.c_str(), (dir / "Reconstructed.cgns").c_str(), "/Base/Cells/FlowSolution");
         }
 
-        ++solutionNo;
-    }
+        //- Write zone iterative data
+        cgsize_t sizes[2] = {32, (cgsize_t) timeValues.size()};
+        cg_ziter_write(fn, 1, 1, "ZoneIterativeData");
+        cg_goto(fn, 1, "Zone_t", 1, "ZoneIterativeData_t", 1, "end");
+        cg_array_write("FlowSolutionPointers", CGNS_ENUMV(Character), 2, sizes, flowSolutionPtrs.str().c_str());
 
-    //- Write zone iterative data
-    cg_ziter_write(fn, 1, 1, "ZoneIterativeData");
-    cg_goto(fn, 1, "Zone_t", 1, "ZoneIterativeData_t", 1, "end");
-    sizes[0] = 32;
-    sizes[1] = timeValues.size();
-    cg_array_write("FlowSolutionPointers", CGNS_ENUMV(Character), 2, sizes, flowSolutionPtrs.str().c_str());
+        //- Write base iterative data
+        cg_biter_write(fn, 1, "TimeIterValues", timeValues.size());
+        cg_goto(fn, 1, "BaseIterativeData_t", 1, "end");
+        cg_array_write("TimeValues", CGNS_ENUMV(RealDouble), 1, &sizes[1], timeValues.data());
+        cg_simulation_type_write(fn, 1, CGNS_ENUMV(TimeAccurate));
 
-    //- Write base iterative data
-    cg_biter_write(fn, 1, "TimeIterValues", timeValues.size());
-    cg_goto(fn, 1, "BaseIterativeData_t", 1, "end");
-    cg_array_write("TimeValues", CGNS_ENUMV(RealDouble), 1, &sizes[1], timeValues.data());
-    cg_simulation_type_write(fn, 1, CGNS_ENUMV(TimeAccurate));
+        //- Finalize
+        cg_close(fn);
+    }
 
-    //- Finalize
-    cg_close(fn);
+    Communicator::finalize();
 
     return 0;
 }